@@ -27,9 +27,28 @@
 #ifndef DIVVY_HPP
 #define DIVVY_HPP
 
+#include "divvy/Accessor.hpp"
+#include "divvy/Allocator.hpp"
+#include "divvy/ChangeLog.hpp"
 #include "divvy/Component.hpp"
 #include "divvy/ComponentPool.hpp"
+#include "divvy/Config.hpp"
 #include "divvy/Entity.hpp"
+#include "divvy/EntityTable.hpp"
+#include "divvy/Event.hpp"
+#include "divvy/Hash.hpp"
+#include "divvy/Hierarchy.hpp"
+#include "divvy/History.hpp"
+#include "divvy/Index.hpp"
+#include "divvy/Log.hpp"
+#include "divvy/Pipeline.hpp"
+#include "divvy/Reflection.hpp"
+#include "divvy/Relation.hpp"
+#include "divvy/Rollback.hpp"
+#include "divvy/Singleton.hpp"
+#include "divvy/Spatial.hpp"
+#include "divvy/Stats.hpp"
+#include "divvy/Runner.hpp"
 #include "divvy/World.hpp"
 
 #endif // DIVVY_HPP
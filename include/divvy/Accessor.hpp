@@ -0,0 +1,92 @@
+#ifndef DIVVY_ACCESSOR_HPP
+#define DIVVY_ACCESSOR_HPP
+
+#include <stdexcept>
+
+#include "Component.hpp"
+#include "ComponentPool.hpp"
+#include "Config.hpp"
+#include "Entity.hpp"
+
+namespace divvy {
+
+	// ===================================[ Accessor ]=======================================
+
+	/**
+	* Accessor resolves the pool of a Component type once, so that Components can be
+	* retrieved in constant time without any lookups. Retrieval is validated according to
+	* DIVVY_CHECK_LEVEL. When unchecked, the Entity has to be valid, belong to the World,
+	* and have the Component.
+	*
+	* An Accessor is invalidated when its Component type is removed from the World.
+	* Components retrieved through operator[] count as changed, like through
+	* Entity::get(), while read() leaves them be.
+	*/
+	template <class T>
+	class Accessor
+	{
+	public:
+		/**
+		* Create an Accessor over a pool. Use World::accessor() instead.
+		*
+		* @param pool      The pool holding the Components.
+		* @param world     The World owning the pool.
+		*/
+		Accessor(pool_type<T>& pool, const World* world)
+			: m_pool(&pool), m_world(world)
+		{
+		}
+
+		/**
+		* Retrieve the Component of an Entity.
+		*
+		* @param entity    The Entity that has the Component.
+		*
+		* @return          Reference to the Component.
+		*/
+		inline component_reference<T> operator[](const Entity& entity) const
+		{
+			DIVVY_CHECK(entity.m_world == m_world, "Entity does not belong to the Accessor's World");
+			DIVVY_CHECK(m_pool->has(entity.m_id), "Component does not exist, cannot access it");
+
+			return (*m_pool)[entity.m_id];
+		}
+
+		/**
+		* Retrieve the Component of an Entity for reading only.
+		*
+		* @param entity    The Entity that has the Component.
+		*
+		* @return          Constant reference to the Component.
+		*/
+		inline const T& read(const Entity& entity) const
+		{
+			DIVVY_CHECK(entity.m_world == m_world, "Entity does not belong to the Accessor's World");
+			DIVVY_CHECK(m_pool->has(entity.m_id), "Component does not exist, cannot access it");
+
+			return static_cast<const pool_type<T>&>(*m_pool)[entity.m_id];
+		}
+
+		/**
+		* Check whether an Entity has the Component.
+		*
+		* @param entity    The Entity to check.
+		*
+		* @return          True if the Entity has the Component, false otherwise.
+		*/
+		inline bool has(const Entity& entity) const
+		{
+			return entity.m_world == m_world && m_pool->has(entity.m_id);
+		}
+
+	private:
+		/// The pool holding the Components
+		pool_type<T>* m_pool;
+
+		/// The World owning the pool
+		const World* m_world;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_ACCESSOR_HPP
@@ -0,0 +1,100 @@
+#ifndef DIVVY_ALLOCATOR_HPP
+#define DIVVY_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/**
+* Default alignment of Component pools, in bytes. A cache line on most hardware, which
+* also satisfies aligned AVX loads. Define before including divvy.hpp to change it.
+*/
+#ifndef DIVVY_POOL_ALIGNMENT
+#define DIVVY_POOL_ALIGNMENT 64
+#endif
+
+namespace divvy {
+
+	/**
+	* The alignment of the storage of a Component pool, in bytes.
+	* Specialize this for a Component type to change the alignment of its pool alone.
+	*/
+	template <class T>
+	struct pool_alignment : std::integral_constant<size_t,
+		(alignof(T) > DIVVY_POOL_ALIGNMENT ? alignof(T) : DIVVY_POOL_ALIGNMENT)> {};
+
+	// ===============================[ AlignedAllocator ]===================================
+
+	/**
+	* Allocator handing out storage aligned to a boundary larger than the type requires,
+	* such as a cache line.
+	*/
+	template <class T, size_t Align>
+	class AlignedAllocator
+	{
+		static_assert(Align && !(Align & (Align - 1)), "Alignment has to be a power of two");
+
+	public:
+		typedef T value_type;
+
+		template <class U>
+		struct rebind
+		{
+			typedef AlignedAllocator<U, Align> other;
+		};
+
+		AlignedAllocator() {}
+
+		template <class U>
+		AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+		/**
+		* Allocate aligned storage. The address of the underlying allocation is kept right
+		* in front of the aligned storage, so it can be released again.
+		*
+		* @param count     Number of elements to allocate storage for.
+		*
+		* @return          Pointer to the aligned storage.
+		*/
+		T* allocate(size_t count)
+		{
+			size_t bytes = count * sizeof(T) + Align + sizeof(void*);
+			char* raw = static_cast<char*>(::operator new(bytes));
+
+			uintptr_t address = reinterpret_cast<uintptr_t>(raw + sizeof(void*));
+			char* aligned = raw + sizeof(void*) + ((Align - address % Align) % Align);
+
+			std::memcpy(aligned - sizeof(void*), &raw, sizeof(void*));
+			return reinterpret_cast<T*>(aligned);
+		}
+
+		/**
+		* Release storage handed out by allocate().
+		*
+		* @param data      Pointer to the aligned storage.
+		*/
+		void deallocate(T* data, size_t)
+		{
+			void* raw;
+			std::memcpy(&raw, reinterpret_cast<char*>(data) - sizeof(void*), sizeof(void*));
+			::operator delete(raw);
+		}
+	};
+
+	template <class T, class U, size_t Align>
+	inline bool operator==(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&)
+	{
+		return true;
+	}
+
+	template <class T, class U, size_t Align>
+	inline bool operator!=(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&)
+	{
+		return false;
+	}
+
+} // namespace divvy
+
+#endif // DIVVY_ALLOCATOR_HPP
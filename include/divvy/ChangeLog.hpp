@@ -0,0 +1,68 @@
+#ifndef DIVVY_CHANGELOG_HPP
+#define DIVVY_CHANGELOG_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace divvy {
+
+	// ===================================[ ChangeLog ]======================================
+
+	/**
+	* Record of the slots of a pool changed since it was last cleared, for those that only
+	* revisit what changed, such as hashing and rollback. Once more slots were recorded
+	* than the pool held when cleared, or a change went untracked, every slot counts as
+	* changed.
+	*/
+	struct ChangeLog
+	{
+		/// Slots changed, possibly more than once
+		std::vector<size_t> slots;
+
+		/// Whether every slot counts as changed
+		bool all = true;
+
+		/// Number of slots recorded past which every slot counts as changed
+		size_t limit = 0;
+
+		/**
+		* Record a changed slot.
+		*
+		* @param index     The EntityID of the slot.
+		*/
+		inline void mark(size_t index)
+		{
+			if (all)
+				return;
+
+			if (slots.size() > limit)
+				markAll();  // Cheaper to revisit every slot
+			else
+				slots.push_back(index);
+		}
+
+		/**
+		* Count every slot as changed.
+		*/
+		inline void markAll()
+		{
+			all = true;
+			slots.clear();
+		}
+
+		/**
+		* Forget the changes recorded.
+		*
+		* @param size      Number of slots in the pool.
+		*/
+		void clear(size_t size)
+		{
+			slots.clear();
+			all = false;
+			limit = size;
+		}
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_CHANGELOG_HPP
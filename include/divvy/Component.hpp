@@ -1,6 +1,12 @@
 #ifndef DIVVY_COMPONENT_HPP
 #define DIVVY_COMPONENT_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+
 namespace divvy {
 
 	// ===================================[ Component ]======================================
@@ -29,33 +35,148 @@ namespace divvy {
 
 		/**
 		* Provide functionality to an Entity.
+		*
+		* A derived type may instead declare `static void updateBatch(T* begin, T* end)`,
+		* which is handed every contiguous run of updating Components at once. The
+		* virtual update method is then never called by the World.
+		*
+		* Types holding data only should declare neither, so that updates skip them and
+		* don't count every Component as written.
 		*/
-		virtual void update() = 0;
+		virtual void update() {}
 
 	protected:
 		/// The Entity that is assigned to this Component.
 		Entity* m_entity = nullptr;
 
 		friend class World;
+
+		template <class T>
+		friend class ComponentPool;
+	};
+
+	// ================================[ SharedComponent ]===================================
+
+	/**
+	* SharedComponent is a base class for data that is identical across many Entities,
+	* such as mesh descriptors or AI parameter blocks. Equal values are stored once and
+	* referenced by every Entity that uses them, and are copied only when mutated.
+	*
+	* Derived types have to be copyable, equality comparable (operator==), and hashable
+	* through a `uint64_t hash() const` method that is equal for equal values.
+	*/
+	class SharedComponent
+	{
+	};
+
+	/**
+	* Defines a shared Component type.
+	*/
+	template <class T>
+	struct is_shared : std::integral_constant<bool, std::is_base_of<SharedComponent, T>::value> {};
+
+	/**
+	* Defines a tag Component type.
+	*
+	* Tags are empty types (e.g. `struct Enemy {};`) that only mark an Entity. Since they
+	* carry no state, they are stored as a single bit per Entity instead of a full Component.
+	* Types deriving from Component are never empty, due to the vtable and m_entity.
+	*/
+	template <class T>
+	struct is_tag : std::integral_constant<bool, std::is_empty<T>::value && !is_shared<T>::value> {};
+
+	/**
+	* Detects `static void T::updateBatch(T* begin, T* end)`, declared by T itself. A batch
+	* update inherited from a base class takes pointers to the base, and stepping them over
+	* an array of T would be undefined, so it is not used.
+	*/
+	template <class T>
+	class has_update_batch
+	{
+		template <class U>
+		static auto test(int) -> typename std::is_same<decltype(&U::updateBatch), void (*)(U*, U*)>::type;
+
+		template <class U>
+		static std::false_type test(...);
+
+	public:
+		static const bool value = decltype(test<T>(0))::value;
+	};
+
+	/**
+	* Detects Component types that have anything to update: an update method overriding
+	* the empty one of Component, or a batch update.
+	*/
+	template <class T>
+	struct has_update : std::integral_constant<bool, has_update_batch<T>::value ||
+		!std::is_same<decltype(&T::update), void (Component::*)()>::value> {};
+
+	/**
+	* Detects `uint64_t T::hash() const`, which World::hash() uses instead of the
+	* Component's bytes.
+	*/
+	template <class T>
+	class has_hash
+	{
+		template <class U>
+		static auto test(int) -> decltype(static_cast<uint64_t>(static_cast<const U*>(nullptr)->hash()), std::true_type());
+
+		template <class U>
+		static std::false_type test(...);
+
+	public:
+		static const bool value = decltype(test<T>(0))::value;
 	};
 
+	/**
+	* Defines a Component type without a hash method whose value is fully described by
+	* its bytes past the Component base, so that World::hash() may hash those. Defaults to
+	* false, since pointers and padding bytes differ across processes. Specialize it for
+	* types made of plain values only, right after defining them:
+	*
+	*    namespace divvy { template <> struct is_byte_hashable<Transform> : std::true_type {}; }
+	*/
+	template <class T>
+	struct is_byte_hashable : std::false_type {};
+
+	/**
+	* Defines a Component type whose objects may be moved between pools by copying their
+	* bytes, after which the source is default-constructed over rather than destroyed.
+	* Defaults to trivially copyable types. Specialize it for types whose members are
+	* safe to move bitwise, such as most standard containers, right after defining them:
+	*
+	*    namespace divvy { template <> struct is_relocatable<Path> : std::true_type {}; }
+	*/
+	template <class T>
+	struct is_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
 	/**
 	* Defines a valid Component type.
 	*
 	* If you are getting a compiler error here, you haven't made a valid Component.
 	*
 	* A valid component has the following characteristics:
-	*    - Publicly inherits the Component class
+	*    - Publicly inherits the Component or SharedComponent class, or is an empty tag type
 	*    - Contains no pure virtual methods
 	*    - Has a default constructor (takes no arguments)
 	*    - Defined before usage ~ not simply forward declared (this is a compile-time check)
 	*/
 	template <class T>
-	using is_valid_component = typename std::enable_if<std::is_base_of<Component, T>::value &&
-													  !std::is_abstract<T>::value &&
+	using is_valid_component = typename std::enable_if<((std::is_base_of<Component, T>::value &&
+													   !std::is_abstract<T>::value) ||
+													   is_shared<T>::value ||
+													   is_tag<T>::value) &&
 													   std::is_default_constructible<T>::value
 													  >::type;
 
+	/**
+	* The reference type handed out for a Component type.
+	* Shared Components are read-only, since writing to them would affect every Entity
+	* sharing the value. Use Entity::mutate() to obtain a private, writable copy instead.
+	*/
+	template <class T>
+	using component_reference = typename std::conditional<is_shared<T>::value, const T&, T&>::type;
+
 	/**
 	* Shorter way to convert Component types when implementing the virtual clone method.
 	*
@@ -69,6 +190,70 @@ namespace divvy {
 		return static_cast<const T&>(other);
 	}
 
+	/**
+	* Description of a Component type, available without knowing the type at compile time.
+	*/
+	struct ComponentInfo
+	{
+		/// The type itself
+		const std::type_info* type;
+
+		/// The implementation-defined name of the type
+		const char* name;
+
+		/// The size of the type, in bytes
+		size_t size;
+
+		/// The alignment of the type, in bytes
+		size_t alignment;
+
+		/// Whether the type can be copied as raw bytes
+		bool trivial;
+
+		/// Whether the type is a shared Component
+		bool shared;
+
+		/// Whether the type is a tag
+		bool tag;
+	};
+
+	/**
+	* Retrieve the description of a Component type.
+	*
+	* @returns         The description of the type.
+	*/
+	template <class T>
+	inline const ComponentInfo& componentInfo()
+	{
+		static const ComponentInfo info = {&typeid(T), typeid(T).name(), sizeof(T), alignof(T),
+			std::is_trivially_copyable<T>::value, is_shared<T>::value, is_tag<T>::value};
+		return info;
+	}
+
+	/**
+	* Generate the next type identification number.
+	*
+	* @returns         A number that has not been handed out before.
+	*/
+	inline size_t nextTypeID()
+	{
+		static std::atomic<size_t> counter(0);
+		return counter++;
+	}
+
+	/**
+	* Retrieve the identification number of a type.
+	* Numbers are sequential and start at zero, so they can index directly into a vector.
+	*
+	* @returns         The identification number of the type.
+	*/
+	template <class T>
+	inline size_t typeID()
+	{
+		static const size_t id = nextTypeID();
+		return id;
+	}
+
 } // namespace Divvy
 
 #endif // DIVVY_COMPONENT_HPP
\ No newline at end of file
@@ -1,12 +1,54 @@
 #ifndef DIVVY_COMPONENT_POOL_HPP
 #define DIVVY_COMPONENT_POOL_HPP
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "Allocator.hpp"
+#include "ChangeLog.hpp"
 #include "Component.hpp"
+#include "Config.hpp"
+#include "Hash.hpp"
+#include "Rollback.hpp"
+#include "Stats.hpp"
 
 namespace divvy {
 
+	// =================================[ ChangeListener ]===================================
+
+	/**
+	* Interface for anything that has to follow the changes made to a pool, such as
+	* indexes over Component values. Listeners are only told which Entity changed, and
+	* are expected to read the new state lazily, since Components returned by mutate()
+	* are modified after the notification.
+	*/
+	class ChangeListener
+	{
+	public:
+		/**
+		* Allow derived listeners to have a destructor.
+		*/
+		virtual ~ChangeListener() {}
+
+		/**
+		* Called whenever a Component is added, mutated, or removed.
+		*
+		* @param index     The EntityID of the Entity.
+		*/
+		virtual void changed(size_t index) = 0;
+
+		/**
+		* Called whenever Components are handed out for writing without saying which, such
+		* as through get() or an update, so that any of them may have changed.
+		*/
+		virtual void changedAll() = 0;
+	};
+
 	// =================================[ BaseComponentPool ]================================
 
 	/**
@@ -23,28 +65,62 @@ namespace divvy {
 		* Add a Component to an Entity
 		*
 		* @param index     The EntityID of the Entity.
+		* @param entity    The Entity that the Component is assigned to.
+		*/
+		virtual void add(size_t index, Entity& entity) = 0;
+
+		/**
+		* Clone a Component of another pool of the same type onto an Entity.
 		*
-		* @return          Reference to the newly added Component.
+		* @param index     The EntityID of the Entity.
+		* @param entity    The Entity that the Component is assigned to.
+		* @param other     The pool holding the Component to clone.
+		* @param from      The EntityID of the Entity to clone from.
+		*/
+		virtual void clone(size_t index, Entity& entity, const BaseComponentPool& other, size_t from) = 0;
+
+		/**
+		* Point the Component of an Entity to the Entity object that now represents it,
+		* such as after the Entity was moved.
+		*
+		* @param index     The EntityID of the Entity.
+		* @param entity    The Entity that the Component is assigned to.
 		*/
-		virtual Component& add(size_t index) = 0;
+		virtual void rebind(size_t index, Entity& entity) = 0;
 
 		/**
-		* Access a Component at the specified index.
+		* Move a Component out of another pool of the same type onto an Entity, removing
+		* it from the other pool.
 		*
 		* @param index     The EntityID of the Entity.
+		* @param entity    The Entity that the Component is assigned to.
+		* @param other     The pool holding the Component to move.
+		* @param from      The EntityID of the Entity to move from.
+		*/
+		virtual void relocate(size_t index, Entity& entity, BaseComponentPool& other, size_t from) = 0;
+
+		/**
+		* Describe the Component type held by the pool.
 		*
-		* @return          Reference to the Component at the index location.
+		* @return          Description of the Component type.
 		*/
-		virtual Component& at(size_t index) = 0;
+		virtual const ComponentInfo& info() const = 0;
 
 		/**
-		* Access a constant Component at the specified index.
+		* Count the Entities that have a Component.
+		*
+		* @return          Number of Components.
+		*/
+		virtual size_t count() const = 0;
+
+		/**
+		* Access the object representation of a Component, for inspecting it generically.
 		*
 		* @param index     The EntityID of the Entity.
 		*
-		* @return          Reference to the Component at the index location.
+		* @return          Pointer to the Component, or nullptr if the Entity doesn't have one.
 		*/
-		virtual const Component& at(size_t index) const = 0;
+		virtual const void* bytes(size_t index) const = 0;
 
 		/**
 		* Returns the reserved capacity of the pool.
@@ -53,6 +129,16 @@ namespace divvy {
 		*/
 		virtual size_t capacity() const = 0;
 
+		/**
+		* Returns the number of Entities the pool can hold before it has to reallocate.
+		*
+		* @return          Allocated capacity
+		*/
+		virtual size_t allocated() const
+		{
+			return capacity();
+		}
+
 		/**
 		* Check if an Entity has a Component
 		*
@@ -77,9 +163,208 @@ namespace divvy {
 		virtual void resize(size_t size) = 0;
 
 		/**
-		* Update all active Components in the pool.
+		* Update all active and enabled Components in the pool.
+		*
+		* @param disabled  Record of the disabled Entities, which are skipped as well.
+		*/
+		virtual void update(const std::vector<bool>& disabled) = 0;
+
+		/**
+		* Allow derived pools to have a destructor.
+		*/
+		virtual ~BaseComponentPool() {}
+
+		/**
+		* Start notifying a listener of changes made to the pool.
+		*
+		* @param listener  The listener to notify.
+		*/
+		void listen(ChangeListener& listener)
+		{
+			m_listeners.push_back(&listener);
+		}
+
+		/**
+		* Stop notifying a listener of changes made to the pool.
+		*
+		* @param listener  The listener to no longer notify.
+		*/
+		void unlisten(ChangeListener& listener)
+		{
+			for (size_t i = 0; i < m_listeners.size(); i++)
+			{
+				if (m_listeners[i] == &listener)
+				{
+					m_listeners.erase(m_listeners.begin() + i);
+					return;
+				}
+			}
+		}
+
+		/**
+		* Enable or disable the Component of an Entity, without removing it.
+		* Disabled Components are kept in place, but skipped by updates and views.
+		*
+		* @param index     The EntityID of the Entity.
+		* @param enabled   Whether the Component should be enabled.
+		*/
+		void setEnabled(size_t index, bool enabled)
+		{
+			if (index >= m_disabled.size())
+			{
+				if (enabled)
+					return;
+
+				m_disabled.resize(index + 1, false);
+			}
+
+			m_disabled[index] = !enabled;
+		}
+
+		/**
+		* Check whether the Component of an Entity is enabled.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          True if enabled, false otherwise.
+		*/
+		inline bool enabled(size_t index) const
+		{
+			return index >= m_disabled.size() || !m_disabled[index];
+		}
+
+		/**
+		* Access the counter of Components added to and removed from this pool.
+		*
+		* @return          Reference to the counter.
+		*/
+		inline ChurnCounter& churn()
+		{
+			return m_churn;
+		}
+
+		/**
+		* Compute a deterministic hash of the pool's state: which Entities have a Component,
+		* and the value of each Component. The hash of every slot is kept, so only the slots
+		* that changed since the previous call are hashed again, including those handed out
+		* by get() and Accessors. Every slot is after spans() or an update, which hand out
+		* every Component for writing. Types without an update are never updated.
+		*
+		* @return          The hash of the pool.
+		*/
+		uint64_t hash()
+		{
+			if (m_hashLog.all)
+			{
+				m_digests.assign(capacity(), 0);
+				m_hash = 0;
+
+				for (size_t i = 0; i < m_digests.size(); i++)
+				{
+					m_digests[i] = digest(i);
+					m_hash += m_digests[i];
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < m_hashLog.slots.size(); i++)
+				{
+					size_t index = m_hashLog.slots[i];
+
+					if (index >= m_digests.size())
+						m_digests.resize(index + 1, 0);
+
+					m_hash -= m_digests[index];
+					m_digests[index] = digest(index);
+					m_hash += m_digests[index];
+				}
+			}
+
+			m_hashLog.clear(m_digests.size());
+
+			return m_hash;
+		}
+
+		/**
+		* Save the state of the pool as a new frame. Only the parts changed since the
+		* previous save are copied, along with what they held before, so that it can be
+		* restored.
+		*
+		* @param frames    Number of frames kept, including this one.
+		*
+		* @return          Number of pages of storage copied.
+		*/
+		virtual size_t save(size_t frames) = 0;
+
+		/**
+		* Restore the state of the pool as of an earlier save, discarding the saves made
+		* after it. Components are restored in place, and may point to Entities that were
+		* since removed, which the World takes care of.
+		*
+		* @param steps     Number of saves to go back, 0 for the latest save.
+		* @param restored  The ranges of slots restored are appended to this, each from its
+		*                  first slot up to but excluding its last.
+		*/
+		virtual void restore(size_t steps, std::vector<std::pair<size_t, size_t>>& restored) = 0;
+
+	protected:
+		/**
+		* Notify all listeners that the Component of an Entity changed.
+		*
+		* @param index     The EntityID of the Entity.
+		*/
+		inline void notify(size_t index)
+		{
+			for (size_t i = 0; i < m_listeners.size(); i++)
+				m_listeners[i]->changed(index);
+
+			m_hashLog.mark(index);
+			m_saveLog.mark(index);
+		}
+
+		/**
+		* Mark every slot as possibly changed, for when Components are handed out for
+		* writing in bulk, such as by spans() or an update.
+		*/
+		inline void touch()
+		{
+			for (size_t i = 0; i < m_listeners.size(); i++)
+				m_listeners[i]->changedAll();
+
+			m_hashLog.markAll();
+			m_saveLog.markAll();
+		}
+
+		/**
+		* Hash the state of a single slot.
+		*
+		* @param index     The EntityID of the slot.
+		*
+		* @return          The hash of the slot, or zero when it holds no Component.
 		*/
-		virtual void update() = 0;
+		virtual uint64_t digest(size_t index) const = 0;
+
+		/// Slots changed since the previous save
+		ChangeLog m_saveLog;
+
+	private:
+		/// Listeners following the changes made to this pool
+		std::vector<ChangeListener*> m_listeners;
+
+		/// Record of the disabled Components
+		std::vector<bool> m_disabled;
+
+		/// Counter of Components added and removed
+		ChurnCounter m_churn;
+
+		/// Hash of every slot as of the previous call to hash()
+		std::vector<uint64_t> m_digests;
+
+		/// Slots changed since the previous call to hash()
+		ChangeLog m_hashLog;
+
+		/// Sum of the hashes of every slot
+		uint64_t m_hash = 0;
 	};
 
 	// ================================[ ComponentPool ]=====================================
@@ -95,24 +380,130 @@ namespace divvy {
 	class ComponentPool : public BaseComponentPool
 	{
 	public:
-		virtual Component& add(size_t index)
+		virtual void add(size_t index, Entity& entity)
+		{
+			DIVVY_CHECK(index < m_pool.size(), "ComponentSegment index out of bounds");
+
+			m_active[index] = true;
+			m_pool[index].m_entity = &entity;
+			notify(index);
+		}
+
+		virtual void clone(size_t index, Entity& entity, const BaseComponentPool& other, size_t from)
+		{
+			add(index, entity);
+			m_pool[index].clone(static_cast<const ComponentPool<T>&>(other).get(from));
+		}
+
+		virtual void rebind(size_t index, Entity& entity)
+		{
+			if (has(index))
+				m_pool[index].m_entity = &entity;
+		}
+
+		virtual void relocate(size_t index, Entity& entity, BaseComponentPool& other, size_t from)
+		{
+			ComponentPool<T>& source = static_cast<ComponentPool<T>&>(other);
+
+			transfer(divvy::at(m_pool, index), divvy::at(source.m_pool, from), std::integral_constant<bool, is_relocatable<T>::value>());
+			add(index, entity);
+			source.remove(from);
+		}
+
+		/**
+		* Add a Component to an Entity, constructed from the arguments given.
+		*
+		* @param index     The EntityID of the Entity.
+		* @param entity    The Entity that the Component is assigned to.
+		* @param args      Arguments to feed to the Component's constructor.
+		*
+		* @return          Reference to the newly added Component.
+		*/
+		template <class ... Args>
+		T& emplace(size_t index, Entity& entity, Args&& ... args)
+		{
+			add(index, entity);
+			m_pool[index].clone(T(std::forward<Args>(args)...));
+			return m_pool[index];
+		}
+
+		/**
+		* Access a Component at the specified index, which counts as changed.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          Reference to the Component at the index location.
+		*/
+		T& get(size_t index)
+		{
+			T& component = divvy::at(m_pool, index);
+			notify(index);
+			return component;
+		}
+
+		/**
+		* Access a constant Component at the specified index.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          Reference to the Component at the index location.
+		*/
+		const T& get(size_t index) const
+		{
+			return divvy::at(m_pool, index);
+		}
+
+		/**
+		* Access a Component without any checks, which counts as changed.
+		*
+		* @param index     The EntityID of an Entity that has the Component.
+		*
+		* @return          Reference to the Component at the index location.
+		*/
+		inline T& operator[](size_t index)
+		{
+			notify(index);
+			return m_pool[index];
+		}
+
+		/**
+		* Access a constant Component without any checks.
+		*
+		* @param index     The EntityID of an Entity that has the Component.
+		*
+		* @return          Reference to the Component at the index location.
+		*/
+		inline const T& operator[](size_t index) const
 		{
-			if (index >= m_pool.size())
-				throw std::runtime_error("ComponentSegment index out of bounds");
+			return m_pool[index];
+		}
 
-			m_active.at(index) = true;
+		/**
+		* Access a Component at the specified index with the intent of modifying it.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          Reference to the Component at the index location.
+		*/
+		T& mutate(size_t index)
+		{
+			notify(index);
+			return divvy::at(m_pool, index);
+		}
 
-			return at(index);
+		virtual const ComponentInfo& info() const
+		{
+			return componentInfo<T>();
 		}
 
-		virtual Component& at(size_t index)
+		virtual size_t count() const
 		{
-			return static_cast<Component&>(m_pool.at(index));
+			return std::count(m_active.begin(), m_active.end(), true);
 		}
 
-		virtual const Component& at(size_t index) const
+		virtual const void* bytes(size_t index) const
 		{
-			return static_cast<const Component&>(m_pool.at(index));
+			return index < m_active.size() && m_active[index] ? &m_pool[index] : nullptr;
 		}
 
 		virtual size_t capacity() const
@@ -120,6 +511,11 @@ namespace divvy {
 			return m_pool.size();
 		}
 
+		virtual size_t allocated() const
+		{
+			return m_pool.capacity();
+		}
+
 		virtual bool has(size_t index)
 		{
 			try
@@ -137,6 +533,7 @@ namespace divvy {
 			try
 			{
 				m_active.at(index) = false;
+				notify(index);
 			}
 			catch (std::out_of_range e)
 			{
@@ -157,22 +554,861 @@ namespace divvy {
 			}
 		}
 
-		virtual void update()
+		virtual void update(const std::vector<bool>& disabled)
+		{
+			if (!has_update<T>::value)
+				return;     // Data only, nothing is written
+
+			touch();
+			update(disabled, std::integral_constant<bool, has_update_batch<T>::value>());
+		}
+
+		virtual size_t save(size_t frames)
+		{
+			size_t copied = m_history.save(m_pool, m_active, m_saveLog, frames);
+			m_saveLog.clear(m_pool.size());
+
+			return copied;
+		}
+
+		virtual void restore(size_t steps, std::vector<std::pair<size_t, size_t>>& restored)
+		{
+			m_history.restore(m_pool, m_active, m_saveLog, steps, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					notify(i);
+
+				restored.push_back(std::make_pair(begin, end));
+			});
+
+			m_saveLog.clear(m_pool.size());
+		}
+
+		/**
+		* Run a function on every contiguous run of active, enabled Components. Runs are
+		* split at aligned boundaries, every multiple of the chunk size rounded up to a whole
+		* number of cache lines, so every chunk lies within a single aligned block. Chunks
+		* from different blocks never share a cache line. The first chunk of a run starts
+		* wherever the run does, though, and may share a line with the last chunk of the
+		* previous run when both lie within the same block.
+		*
+		* @param disabled  Record of the disabled Entities, which are skipped.
+		* @param chunk     Least number of Components per chunk, or 0 to not split runs.
+		* @param fn        Function taking (T* begin, T* end).
+		*/
+		template <class Func>
+		void spans(const std::vector<bool>& disabled, size_t chunk, Func fn)
+		{
+			touch();
+
+			if (chunk)
+				chunk = (chunk + stride() - 1) / stride() * stride();
+
+			runs(disabled, [&](T* begin, T* end)
+			{
+				if (!chunk)
+				{
+					fn(begin, end);
+					return;
+				}
+
+				// Split on multiples of the chunk size, counted from the start of the pool
+				size_t first = begin - m_pool.data(), last = end - m_pool.data();
+
+				while (first < last)
+				{
+					size_t boundary = std::min(last, (first / chunk + 1) * chunk);
+					fn(m_pool.data() + first, m_pool.data() + boundary);
+					first = boundary;
+				}
+			});
+		}
+
+		/**
+		* Retrieve the least number of Components between two aligned addresses.
+		*
+		* @return          Number of Components.
+		*/
+		static size_t stride()
 		{
-			for (unsigned int i = 0; i < m_pool.size(); i++)
+			size_t a = pool_alignment<T>::value, b = sizeof(T);
+
+			while (b)
 			{
-				if (m_active.at(i))
-					m_pool.at(i).update();
+				size_t rest = a % b;
+				a = b;
+				b = rest;
 			}
+
+			return pool_alignment<T>::value / a;  // Alignment over gcd(alignment, size)
 		}
 
 	private:
-		/// Collection of the specified derived Component
-		std::vector<T> m_pool;
+		/**
+		* Update the Components one at a time, through their virtual update method.
+		*/
+		void update(const std::vector<bool>& disabled, std::false_type)
+		{
+			for (size_t i = 0; i < m_pool.size(); i++)
+			{
+				if (updating(i, disabled))
+					m_pool[i].update();
+			}
+		}
 
-		/// Record of the active Components
-		std::vector<bool> m_active;
-	};
+		/**
+		* Hand every contiguous run of updating Components to T::updateBatch at once.
+		*/
+		void update(const std::vector<bool>& disabled, std::true_type)
+		{
+			runs(disabled, [](T* begin, T* end) { T::updateBatch(begin, end); });
+		}
+
+		/**
+		* Run a function on every contiguous run of updating Components.
+		*/
+		template <class Func>
+		void runs(const std::vector<bool>& disabled, Func fn)
+		{
+			size_t i = 0;
+
+			while (i < m_pool.size())
+			{
+				if (!updating(i, disabled))
+				{
+					i++;
+					continue;
+				}
+
+				size_t end = i + 1;
+
+				while (end < m_pool.size() && updating(end, disabled))
+					end++;
+
+				fn(m_pool.data() + i, m_pool.data() + end);
+				i = end;
+			}
+		}
+
+		virtual uint64_t digest(size_t index) const
+		{
+			if (!m_active[index])
+				return 0;
+
+			return hash::slot(index, digest(m_pool[index], std::integral_constant<bool, has_hash<T>::value>()));
+		}
+
+		/**
+		* Hash a Component through its hash method.
+		*/
+		static uint64_t digest(const T& component, std::true_type)
+		{
+			return component.hash();
+		}
+
+		/**
+		* Hash a Component without a hash method, by its bytes if its type allows it.
+		*/
+		static uint64_t digest(const T& component, std::false_type)
+		{
+			return digestBytes(component, std::integral_constant<bool, is_byte_hashable<T>::value>());
+		}
+
+		/**
+		* Hash the bytes of a Component that follow the Component base, which only holds
+		* the vtable and the Entity, neither of which is the same across processes.
+		*/
+		static uint64_t digestBytes(const T& component, std::true_type)
+		{
+			const char* bytes = reinterpret_cast<const char*>(&component);
+			return hash::bytes(bytes + sizeof(Component), sizeof(T) - sizeof(Component));
+		}
+
+		/**
+		* Refuse to hash a Component whose bytes may hold pointers or padding.
+		*/
+		static uint64_t digestBytes(const T&, std::false_type)
+		{
+			throw std::runtime_error("Component type has no hash() method and is not byte hashable, cannot hash it");
+		}
+
+		/**
+		* Move a Component by copying its bytes, then reinitialize the source in place.
+		*/
+		static void transfer(T& to, T& from, std::true_type)
+		{
+			to.~T();
+			std::memcpy(static_cast<void*>(&to), static_cast<const void*>(&from), sizeof(T));
+			new (&from) T();
+		}
+
+		/**
+		* Move a Component through its move assignment, or clone it without one.
+		*/
+		static void transfer(T& to, T& from, std::false_type)
+		{
+			assign(to, from, std::integral_constant<bool, std::is_move_assignable<T>::value>());
+		}
+
+		static void assign(T& to, T& from, std::true_type)
+		{
+			to = std::move(from);
+		}
+
+		static void assign(T& to, T& from, std::false_type)
+		{
+			to.clone(from);
+		}
+
+		/**
+		* Check whether the Component at an index takes part in an update.
+		*/
+		inline bool updating(size_t index, const std::vector<bool>& disabled) const
+		{
+			return m_active[index] && enabled(index) && (index >= disabled.size() || !disabled[index]);
+		}
+
+		/// Collection of the specified derived Component, aligned as configured
+		std::vector<T, AlignedAllocator<T, pool_alignment<T>::value>> m_pool;
+
+		/// Record of the active Components
+		std::vector<bool> m_active;
+
+		/// Saved frames of the Components, for rollback
+		PageHistory<T> m_history;
+	};
+
+	// ===================================[ TagPool ]========================================
+
+	/**
+	* Derived polymorphic container for tag Components.
+	* Tags are empty, so only a single bit per Entity is stored. Every Entity shares the
+	* pool's single instance of the tag.
+	*/
+	template <class T>
+	class TagPool : public BaseComponentPool
+	{
+	public:
+		virtual void add(size_t index, Entity&)
+		{
+			if (index >= m_active.size())
+				throw std::runtime_error("TagPool index out of bounds");
+
+			m_active[index] = true;
+			notify(index);
+		}
+
+		virtual void clone(size_t index, Entity& entity, const BaseComponentPool&, size_t)
+		{
+			add(index, entity);
+		}
+
+		virtual void rebind(size_t, Entity&)
+		{
+			// Tags don't refer back to their Entity
+		}
+
+		virtual void relocate(size_t index, Entity& entity, BaseComponentPool& other, size_t from)
+		{
+			add(index, entity);
+			other.remove(from);
+		}
+
+		/**
+		* Add a tag to an Entity.
+		*
+		* @param index     The EntityID of the Entity.
+		* @param entity    The Entity that the tag is assigned to.
+		*
+		* @return          Reference to the shared tag instance.
+		*/
+		template <class ... Args>
+		T& emplace(size_t index, Entity& entity, Args&& ...)
+		{
+			add(index, entity);
+			return m_tag;
+		}
+
+		/**
+		* Access the tag of an Entity.
+		*
+		* @return          Reference to the shared tag instance.
+		*/
+		T& get(size_t)
+		{
+			return m_tag;
+		}
+
+		/**
+		* Access the constant tag of an Entity.
+		*
+		* @return          Reference to the shared tag instance.
+		*/
+		const T& get(size_t) const
+		{
+			return m_tag;
+		}
+
+		inline T& operator[](size_t)
+		{
+			return m_tag;
+		}
+
+		inline const T& operator[](size_t) const
+		{
+			return m_tag;
+		}
+
+		/**
+		* Access the tag of an Entity with the intent of modifying it.
+		*
+		* @return          Reference to the shared tag instance.
+		*/
+		T& mutate(size_t index)
+		{
+			notify(index);
+			return m_tag;
+		}
+
+		virtual const ComponentInfo& info() const
+		{
+			return componentInfo<T>();
+		}
+
+		virtual size_t count() const
+		{
+			return std::count(m_active.begin(), m_active.end(), true);
+		}
+
+		virtual const void* bytes(size_t index) const
+		{
+			return index < m_active.size() && m_active[index] ? &m_tag : nullptr;
+		}
+
+		virtual size_t capacity() const
+		{
+			return m_active.size();
+		}
+
+		virtual size_t allocated() const
+		{
+			return m_active.capacity();
+		}
+
+		virtual bool has(size_t index)
+		{
+			return index < m_active.size() && m_active[index];
+		}
+
+		virtual void remove(size_t index)
+		{
+			if (index >= m_active.size())
+				throw std::runtime_error("Cannot remove, Entity out of bounds");
+
+			m_active[index] = false;
+			notify(index);
+		}
+
+		virtual void resize(size_t size)
+		{
+			m_active.resize(size, false);
+		}
+
+		virtual void update(const std::vector<bool>&)
+		{
+			// Tags have no functionality to update
+		}
+
+		virtual size_t save(size_t frames)
+		{
+			size_t copied = m_history.save(m_active, m_saveLog.all || !m_saveLog.slots.empty(), frames);
+			m_saveLog.clear(m_active.size());
+
+			return copied;
+		}
+
+		virtual void restore(size_t steps, std::vector<std::pair<size_t, size_t>>& restored)
+		{
+			if (!m_history.saved())
+				return;
+
+			const std::vector<bool>& saved = m_history.restore(steps);
+
+			for (size_t i = 0; i < m_active.size(); i++)
+			{
+				bool active = i < saved.size() && saved[i];
+
+				if (m_active[i] != active)
+				{
+					m_active[i] = active;
+					notify(i);
+
+					if (!restored.empty() && restored.back().second == i)
+						restored.back().second++;
+					else
+						restored.push_back(std::make_pair(i, i + 1));
+				}
+			}
+
+			m_saveLog.clear(m_active.size());
+		}
+
+	protected:
+		virtual uint64_t digest(size_t index) const
+		{
+			return index < m_active.size() && m_active[index] ? hash::slot(index, 0) : 0;
+		}
+
+	private:
+		/// The single instance shared by every tagged Entity
+		T m_tag;
+
+		/// Record of the tagged Entities
+		std::vector<bool> m_active;
+
+		/// Saved frames of the tagged Entities, for rollback
+		StateHistory<std::vector<bool>> m_history;
+	};
+
+	// ==================================[ SharedPool ]======================================
+
+	/**
+	* Derived polymorphic container for shared Components.
+	* Equal values are stored only once, and each Entity holds an index to its value. A
+	* value is copied only when an Entity sharing it with others mutates it. Entities
+	* are grouped by value, so all Entities sharing a value can be processed together.
+	*/
+	template <class T>
+	class SharedPool : public BaseComponentPool
+	{
+		static_assert(has_hash<T>::value, "Shared Component types need a `uint64_t hash() const` method, equal for equal values");
+
+	public:
+		virtual void add(size_t index, Entity& entity)
+		{
+			emplace(index, entity);
+		}
+
+		virtual void clone(size_t index, Entity& entity, const BaseComponentPool& other, size_t from)
+		{
+			if (&other == this)     // Same pool - share the value
+			{
+				if (index >= m_index.size())
+					throw std::runtime_error("SharedPool index out of bounds");
+
+				unbind(index);
+				bind(index, m_index.at(from));
+				notify(index);
+			}
+			else                    // Different pool - deduplicate against this pool's values
+			{
+				emplace(index, entity, static_cast<const SharedPool<T>&>(other).get(from));
+			}
+		}
+
+		virtual void rebind(size_t, Entity&)
+		{
+			// Shared values don't refer back to their Entities
+		}
+
+		virtual void relocate(size_t index, Entity& entity, BaseComponentPool& other, size_t from)
+		{
+			clone(index, entity, other, from);  // Values are deduplicated, not owned
+			other.remove(from);
+		}
+
+		/**
+		* Assign a value to an Entity, reusing an equal value if one is already stored.
+		*
+		* @param index     The EntityID of the Entity.
+		* @param args      Arguments to feed to the value's constructor.
+		*
+		* @return          Reference to the shared value.
+		*/
+		template <class ... Args>
+		const T& emplace(size_t index, Entity&, Args&& ... args)
+		{
+			if (index >= m_index.size())
+				throw std::runtime_error("SharedPool index out of bounds");
+
+			T value(std::forward<Args>(args)...);
+
+			unbind(index);
+			bind(index, find(value));
+			notify(index);
+
+			return m_values[m_index[index]];
+		}
+
+		/**
+		* Access the value of an Entity.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          Reference to the shared value.
+		*/
+		const T& get(size_t index) const
+		{
+			return m_values[divvy::at(m_index, index)];
+		}
+
+		/**
+		* Access the value of an Entity without any checks.
+		*
+		* @param index     The EntityID of an Entity that has a value.
+		*
+		* @return          Reference to the shared value.
+		*/
+		inline const T& operator[](size_t index) const
+		{
+			return m_values[m_index[index]];
+		}
+
+		/**
+		* Access the value of an Entity with the intent of modifying it.
+		* If the value is shared with other Entities, the Entity receives its own copy first.
+		* The value is deduplicated against again from the next value added on, so modify it
+		* before then.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          Reference to the Entity's private value.
+		*/
+		T& mutate(size_t index)
+		{
+			size_t slot = divvy::at(m_index, index);
+
+			if (m_members[slot].size() > 1)
+			{
+				T value(m_values[slot]);
+
+				unbind(index);
+				slot = allocate(std::move(value));
+				bind(index, slot);
+			}
+			else
+			{
+				unindex(slot);
+			}
+
+			m_pending.push_back(slot);
+			notify(index);
+			return m_values[slot];
+		}
+
+		/**
+		* Run a function on every stored value along with the Entities sharing it.
+		*
+		* @param fn        Function taking (const T& value, const std::vector<size_t>& members).
+		*/
+		template <class Func>
+		void each(Func fn) const
+		{
+			for (size_t slot = 0; slot < m_values.size(); slot++)
+				if (!m_members[slot].empty())
+					fn(m_values[slot], m_members[slot]);
+		}
+
+		/**
+		* Returns the number of distinct values stored.
+		*
+		* @return          Number of distinct values.
+		*/
+		size_t values() const
+		{
+			return m_values.size() - m_free.size();
+		}
+
+		virtual const ComponentInfo& info() const
+		{
+			return componentInfo<T>();
+		}
+
+		virtual size_t count() const
+		{
+			return m_index.size() - std::count(m_index.begin(), m_index.end(), npos);
+		}
+
+		virtual const void* bytes(size_t index) const
+		{
+			return index < m_index.size() && m_index[index] != npos ? &m_values[m_index[index]] : nullptr;
+		}
+
+		virtual size_t capacity() const
+		{
+			return m_index.size();
+		}
+
+		virtual size_t allocated() const
+		{
+			return m_index.capacity();
+		}
+
+		virtual bool has(size_t index)
+		{
+			return index < m_index.size() && m_index[index] != npos;
+		}
+
+		virtual void remove(size_t index)
+		{
+			if (index >= m_index.size())
+				throw std::runtime_error("Cannot remove, Entity out of bounds");
+
+			unbind(index);
+			notify(index);
+		}
+
+		virtual void resize(size_t size)
+		{
+			try
+			{
+				for (size_t i = size; i < m_index.size(); i++)
+					unbind(i);
+
+				m_index.resize(size, npos);
+				m_position.resize(size, npos);
+			}
+			catch (const std::bad_alloc&)
+			{
+				throw std::runtime_error("Failed to resize SharedPool");
+			}
+		}
+
+		virtual void update(const std::vector<bool>&)
+		{
+			// Shared values are data only
+		}
+
+		virtual size_t save(size_t frames)
+		{
+			State state;
+
+			if (m_saveLog.all || !m_saveLog.slots.empty())
+				state = State{m_values, m_members, m_free, m_index, m_position};
+
+			size_t copied = m_history.save(state, m_saveLog.all || !m_saveLog.slots.empty(), frames);
+			m_saveLog.clear(m_index.size());
+
+			return copied;
+		}
+
+		virtual void restore(size_t steps, std::vector<std::pair<size_t, size_t>>& restored)
+		{
+			if (!m_history.saved())
+				return;
+
+			const State& saved = m_history.restore(steps);
+			size_t size = m_index.size();
+
+			m_values = saved.values;
+			m_members = saved.members;
+			m_free = saved.free;
+			m_index = saved.index;
+			m_position = saved.position;
+
+			// Slots added since held no value
+			m_index.resize(size, npos);
+			m_position.resize(size, npos);
+
+			m_lookup.clear();
+			m_indexed.assign(m_values.size(), false);
+			m_pending.clear();
+
+			for (size_t slot = 0; slot < m_values.size(); slot++)
+				if (!m_members[slot].empty())
+					index(slot);
+
+			for (size_t i = 0; i < size; i++)
+				notify(i);
+
+			restored.push_back(std::make_pair(size_t(0), size));
+			m_saveLog.clear(size);
+		}
+
+	protected:
+		virtual uint64_t digest(size_t index) const
+		{
+			if (index >= m_index.size() || m_index[index] == npos)
+				return 0;
+
+			return hash::slot(index, m_values[m_index[index]].hash());
+		}
+
+	private:
+		/**
+		* Find the slot of a value equal to the one given, storing it if there is none.
+		*
+		* @param value     The value to look for.
+		*
+		* @return          The slot of the value.
+		*/
+		size_t find(T& value)
+		{
+			// Values mutated since are looked up by their new contents
+			for (size_t i = 0; i < m_pending.size(); i++)
+				if (!m_members[m_pending[i]].empty())
+					index(m_pending[i]);
+
+			m_pending.clear();
+
+			auto range = m_lookup.equal_range(value.hash());
+
+			for (auto it = range.first; it != range.second; ++it)
+				if (m_values[it->second] == value)
+					return it->second;
+
+			size_t slot = allocate(std::move(value));
+			index(slot);
+			return slot;
+		}
+
+		/**
+		* Make a value slot findable by its contents.
+		*/
+		void index(size_t slot)
+		{
+			if (!m_indexed[slot])
+			{
+				m_lookup.emplace(m_values[slot].hash(), slot);
+				m_indexed[slot] = true;
+			}
+		}
+
+		/**
+		* Stop finding a value slot by its contents, such as before they change.
+		*/
+		void unindex(size_t slot)
+		{
+			if (!m_indexed[slot])
+				return;
+
+			auto range = m_lookup.equal_range(m_values[slot].hash());
+
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second == slot)
+				{
+					m_lookup.erase(it);
+					break;
+				}
+			}
+
+			m_indexed[slot] = false;
+		}
+
+		/**
+		* Store a value in a free slot.
+		*
+		* @param value     The value to store.
+		*
+		* @return          The slot of the value.
+		*/
+		size_t allocate(T&& value)
+		{
+			if (!m_free.empty())
+			{
+				size_t slot = m_free.back();
+				m_free.pop_back();
+				m_values[slot] = std::move(value);
+				return slot;
+			}
+
+			m_values.push_back(std::move(value));
+			m_members.emplace_back();
+			m_indexed.push_back(false);
+			return m_values.size() - 1;
+		}
+
+		/**
+		* Reference a value slot from an Entity.
+		*/
+		void bind(size_t index, size_t slot)
+		{
+			m_index[index] = slot;
+			m_position[index] = m_members[slot].size();
+			m_members[slot].push_back(index);
+		}
+
+		/**
+		* Release an Entity's value slot, freeing the slot when nothing references it.
+		*/
+		void unbind(size_t index)
+		{
+			size_t slot = m_index[index];
+
+			if (slot == npos)
+				return;
+
+			// Swap the last member into the released position
+			std::vector<size_t>& members = m_members[slot];
+			size_t last = members.back();
+			members[m_position[index]] = last;
+			m_position[last] = m_position[index];
+			members.pop_back();
+
+			m_index[index] = npos;
+			m_position[index] = npos;
+
+			if (members.empty())
+			{
+				unindex(slot);
+				m_values[slot] = T();
+				m_free.push_back(slot);
+			}
+		}
+
+		/// Marks an Entity without a value
+		static const size_t npos = static_cast<size_t>(-1);
+
+		/// Distinct values, each stored once
+		std::vector<T> m_values;
+
+		/// Entities referencing each value slot
+		std::vector<std::vector<size_t>> m_members;
+
+		/// Value slots that are no longer referenced
+		std::vector<size_t> m_free;
+
+		/// Value slots by the hash of their contents, to deduplicate in constant time
+		std::unordered_multimap<uint64_t, size_t> m_lookup;
+
+		/// Whether each value slot is in the lookup
+		std::vector<bool> m_indexed;
+
+		/// Value slots mutated since the last lookup, to index again by their new contents
+		std::vector<size_t> m_pending;
+
+		/// Value slot of every Entity
+		std::vector<size_t> m_index;
+
+		/// Position of every Entity within its value's members
+		std::vector<size_t> m_position;
+
+		/**
+		* Everything a SharedPool holds, for rollback.
+		*/
+		struct State
+		{
+			std::vector<T> values;
+			std::vector<std::vector<size_t>> members;
+			std::vector<size_t> free;
+			std::vector<size_t> index;
+			std::vector<size_t> position;
+		};
+
+		/// Saved frames of the values and who shares them
+		StateHistory<State> m_history;
+	};
+
+	template <class T>
+	const size_t SharedPool<T>::npos;
+
+	/**
+	* Selects the pool that stores a Component type, based on its characteristics.
+	*/
+	template <class T>
+	using pool_type = typename std::conditional<is_tag<T>::value, TagPool<T>,
+					  typename std::conditional<is_shared<T>::value, SharedPool<T>, ComponentPool<T>>::type>::type;
 
 } // namespace divvy
 
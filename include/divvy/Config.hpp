@@ -0,0 +1,70 @@
+#ifndef DIVVY_CONFIG_HPP
+#define DIVVY_CONFIG_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/**
+* How thoroughly Divvy validates its use on the hot paths, such as retrieving Components.
+*    2 - Full validation, throwing std::runtime_error with a description (default)
+*    1 - Assertions only, which abort in debug builds
+*    0 - Unchecked (default when NDEBUG is defined)
+*
+* Define before including divvy.hpp to choose a level.
+*/
+#ifndef DIVVY_CHECK_LEVEL
+#ifdef NDEBUG
+#define DIVVY_CHECK_LEVEL 0
+#else
+#define DIVVY_CHECK_LEVEL 2
+#endif
+#endif
+
+/**
+* Validate a condition according to DIVVY_CHECK_LEVEL. The condition is not evaluated
+* at all when unchecked, so it must not have side effects.
+*/
+#if DIVVY_CHECK_LEVEL >= 2
+#define DIVVY_CHECK(condition, message) do { if (!(condition)) throw std::runtime_error(message); } while (false)
+#elif DIVVY_CHECK_LEVEL == 1
+#define DIVVY_CHECK(condition, message) assert((condition) && message)
+#else
+#define DIVVY_CHECK(condition, message) ((void)0)
+#endif
+
+/**
+* Size in bytes of the pages of Component storage that rollback saves copy when they
+* changed. Smaller pages copy less per change, but keep more bookkeeping.
+*/
+#ifndef DIVVY_PAGE_SIZE
+#define DIVVY_PAGE_SIZE 4096
+#endif
+
+namespace divvy {
+
+	/**
+	* Access an element of a container, bounds checked according to DIVVY_CHECK_LEVEL.
+	*
+	* @param container The container to access.
+	* @param index     The position of the element.
+	*
+	* @return          Reference to the element.
+	*/
+	template <class Container>
+	inline auto at(Container& container, size_t index) -> decltype(container[index])
+	{
+#if DIVVY_CHECK_LEVEL >= 2
+		if (index >= container.size())
+			throw std::runtime_error("Index " + std::to_string(index) + " out of bounds, there are only " +
+				std::to_string(container.size()) + " elements");
+#else
+		DIVVY_CHECK(index < container.size(), "Index out of bounds");
+#endif
+		return container[index];
+	}
+
+} // namespace divvy
+
+#endif // DIVVY_CONFIG_HPP
@@ -1,7 +1,7 @@
 #ifndef DIVVY_ENTITY_HPP
 #define DIVVY_ENTITY_HPP
 
-#include <iostream>
+#include <ostream>
 
 #include "Component.hpp"
 
@@ -67,7 +67,7 @@ namespace divvy {
 		* @return          A reference to the Component assigned.
 		*/
 		template <class T, class ... Args, typename = is_valid_component<T>>
-		inline T& add(Args&& ... args);
+		inline component_reference<T> add(Args&& ... args);
 
 		/**
 		* Check if a Component is assigned to this Entity.
@@ -78,12 +78,30 @@ namespace divvy {
 		inline bool has();
 
 		/**
-		* Retrieve a Component
+		* Retrieve a Component. It counts as changed, since it may be written through the
+		* reference, so indexes, hashing, and rollback revisit it.
 		*
 		* @return          Reference to the Component.
 		*/
 		template <class T, typename = is_valid_component<T>>
-		inline T& get();
+		inline component_reference<T> get();
+
+		/**
+		* Retrieve a Component for reading only, which doesn't count as changed.
+		*
+		* @return          Constant reference to the Component.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		inline const T& read() const;
+
+		/**
+		* Retrieve a Component with the intent of modifying it.
+		* A shared Component is copied first if other Entities share its value.
+		*
+		* @return          Reference to the Component.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		inline T& mutate();
 
 		/**
 		* Remove a Component from this Entity.
@@ -91,6 +109,88 @@ namespace divvy {
 		template <class T, typename = is_valid_component<T>>
 		inline void remove();
 
+		/**
+		* Attach this Entity to a parent Entity of the same World.
+		*
+		* @param parent    The Entity to become the parent.
+		*/
+		inline void setParent(Entity& parent);
+
+		/**
+		* Detach this Entity from its parent.
+		*/
+		inline void removeParent();
+
+		/**
+		* Retrieve the parent of this Entity.
+		*
+		* @return          Pointer to the parent, or nullptr if there is none.
+		*/
+		inline Entity* parent();
+
+		/**
+		* Enable or disable this Entity. Disabled Entities keep their Components, but are
+		* skipped by World::update() and all views. Toggling is constant time.
+		*
+		* @param enabled   Whether the Entity should be enabled.
+		*/
+		inline void setEnabled(bool enabled);
+
+		/**
+		* Check whether this Entity is valid and enabled.
+		*
+		* @return          True if enabled, false otherwise.
+		*/
+		inline bool enabled() const;
+
+		/**
+		* Enable or disable a Component of this Entity, without removing it.
+		*
+		* @param enabled   Whether the Component should be enabled.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		inline void setEnabled(bool enabled);
+
+		/**
+		* Check whether a Component of this Entity is assigned and enabled.
+		*
+		* @return          True if enabled, false otherwise.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		inline bool enabled();
+
+		/**
+		* Relate this Entity to a target Entity, forming the pair (R, target).
+		* R is any type naming the relation, e.g. `struct Targets {};`.
+		*
+		* @param target    The Entity to relate to.
+		*/
+		template <class R>
+		inline void relate(const Entity& target);
+
+		/**
+		* Check whether this Entity relates to a target Entity.
+		*
+		* @param target    The Entity to check.
+		*
+		* @return          True if the pair (R, target) exists, false otherwise.
+		*/
+		template <class R>
+		inline bool related(const Entity& target);
+
+		/**
+		* Remove the pair (R, target) from this Entity.
+		*
+		* @param target    The Entity to no longer relate to.
+		*/
+		template <class R>
+		inline void unrelate(const Entity& target);
+
+		/**
+		* Recreate an unvalid Entity, removing all of its descendants as well.
+		*/
+		inline void resetTree();
+
 		/**
 		* Recreate an unvalid Entity.
 		*/
@@ -135,6 +235,26 @@ namespace divvy {
 			return (m_world == nullptr ? false : true);
 		}
 
+		/**
+		* Retrieve the EntityID of the slot the Entity lives in.
+		*
+		* @return the EntityID, only meaningful while valid.
+		*/
+		inline EntityID id() const
+		{
+			return m_id;
+		}
+
+		/**
+		* Retrieve the World the Entity exists in.
+		*
+		* @return pointer to the World, or nullptr if invalid.
+		*/
+		inline World* world() const
+		{
+			return m_world;
+		}
+
 		/**
 		* Converts Entity to boolean based on whether or not it is valid.
 		*
@@ -154,12 +274,14 @@ namespace divvy {
 
 		friend class World;
 
-#ifdef DIVVY_DEBUG
+		template <class T>
+		friend class Accessor;
+
+		friend class ComponentType;
+
 		friend std::ostream& operator<<(std::ostream& stream, const Entity& entity);
-#endif
 	};
 
-#ifdef DIVVY_DEBUG
 	/**
 	* Display the EntityID of an Entity to a standard output stream.
 	*
@@ -168,12 +290,11 @@ namespace divvy {
 	*
 	* @return              Returns stream for further usage.
 	*/
-	std::ostream& operator<<(std::ostream& stream, const Entity& entity)
+	inline std::ostream& operator<<(std::ostream& stream, const Entity& entity)
 	{
 		stream << "Entity #" << entity.m_id;
 		return stream;
 	}
-#endif
 
 } // namespace divvy
 
@@ -0,0 +1,206 @@
+#ifndef DIVVY_ENTITYTABLE_HPP
+#define DIVVY_ENTITYTABLE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Config.hpp"
+#include "Entity.hpp"
+
+namespace divvy {
+
+	// ==================================[ EntityTable ]=====================================
+
+	/**
+	* Dense table of Entity slots indexed by EntityID. Every slot holds the Entity living
+	* in it, or nullptr when the slot is dead, along with a generation that increments each
+	* time the slot is released. Creating, removing, and looking up Entities are all
+	* constant time: released slots go onto a free list and are reused last in, first out.
+	*
+	* A released slot can also be held back from the free list, such as the warm slots
+	* kept for a prefab, and opened later.
+	*/
+	class EntityTable
+	{
+	public:
+		/**
+		* Take a slot for a new Entity, reusing an open slot whenever possible.
+		*
+		* @param entity    The Entity to live in the slot.
+		*
+		* @return          The EntityID of the slot.
+		*/
+		size_t acquire(Entity& entity)
+		{
+			size_t id;
+
+			if (!m_open.empty())
+			{
+				id = m_open.back();
+				m_open.pop_back();
+			}
+			else
+			{
+				id = m_slots.size();
+				m_slots.push_back(Slot());
+			}
+
+			bind(id, entity);
+			return id;
+		}
+
+		/**
+		* Bring a dead slot back to life, without going through the free list.
+		*
+		* @param id        The EntityID of the slot, held back when it was released.
+		* @param entity    The Entity to live in the slot.
+		*/
+		void bind(size_t id, Entity& entity)
+		{
+			m_slots[id].entity = &entity;
+			m_count++;
+		}
+
+		/**
+		* Point a living slot to the Entity that replaced its previous one.
+		*
+		* @param id        The EntityID of the slot.
+		* @param entity    The Entity now living in the slot.
+		*/
+		void rebind(size_t id, Entity& entity)
+		{
+			at(m_slots, id).entity = &entity;
+		}
+
+		/**
+		* Kill a living slot and bump its generation.
+		*
+		* @param id        The EntityID of the slot.
+		* @param open      Whether the slot goes onto the free list, or is held back.
+		*/
+		void release(size_t id, bool open = true)
+		{
+			m_slots[id].entity = nullptr;
+			m_slots[id].generation++;
+			m_count--;
+
+			if (open)
+				m_open.push_back(id);
+		}
+
+		/**
+		* Put a slot that was held back onto the free list.
+		*
+		* @param id        The EntityID of the dead slot.
+		*/
+		void open(size_t id)
+		{
+			m_open.push_back(id);
+		}
+
+		/**
+		* Check whether a slot holds a living Entity.
+		*
+		* @param id        The EntityID of the slot.
+		*
+		* @return          True if alive, false if dead or out of range.
+		*/
+		inline bool alive(size_t id) const
+		{
+			return id < m_slots.size() && m_slots[id].entity;
+		}
+
+		/**
+		* Retrieve the Entity living in a slot.
+		*
+		* @param id        The EntityID of the living slot.
+		*
+		* @return          Reference to the Entity.
+		*/
+		inline Entity& operator[](size_t id) const
+		{
+			DIVVY_CHECK(alive(id), "Entity non-existent, cannot look it up");
+			return *m_slots[id].entity;
+		}
+
+		/**
+		* Retrieve the generation of a slot, which changes whenever its Entity is removed.
+		*
+		* @param id        The EntityID of the slot.
+		*
+		* @return          The generation of the slot.
+		*/
+		inline size_t generation(size_t id) const
+		{
+			return at(m_slots, id).generation;
+		}
+
+		/**
+		* Run a function on every living Entity.
+		*
+		* @param fn        Function taking (Entity& entity).
+		*/
+		template <class Func>
+		void each(Func fn) const
+		{
+			for (size_t i = 0; i < m_slots.size(); i++)
+				if (m_slots[i].entity)
+					fn(*m_slots[i].entity);
+		}
+
+		/**
+		* Retrieve the number of slots, living or dead.
+		*
+		* @return          Number of slots.
+		*/
+		inline size_t size() const
+		{
+			return m_slots.size();
+		}
+
+		/**
+		* Retrieve the number of living Entities.
+		*
+		* @return          Number of Entities.
+		*/
+		inline size_t count() const
+		{
+			return m_count;
+		}
+
+		/**
+		* Check whether the next acquired slot will be reused rather than added.
+		*
+		* @return          True if a slot is open, false otherwise.
+		*/
+		inline bool reusable() const
+		{
+			return !m_open.empty();
+		}
+
+	private:
+		/**
+		* A single row of the table.
+		*/
+		struct Slot
+		{
+			/// The Entity living in the slot, or nullptr when dead
+			Entity* entity = nullptr;
+
+			/// Number of times the slot was released
+			size_t generation = 0;
+		};
+
+		/// Slots indexed by EntityID
+		std::vector<Slot> m_slots;
+
+		/// Dead slots available for reuse, the most recently released last
+		std::vector<size_t> m_open;
+
+		/// Number of living slots
+		size_t m_count = 0;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_ENTITYTABLE_HPP
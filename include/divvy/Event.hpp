@@ -0,0 +1,132 @@
+#ifndef DIVVY_EVENT_HPP
+#define DIVVY_EVENT_HPP
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace divvy {
+
+	/**
+	* The points of a World update at which event listeners are run.
+	*/
+	enum class EventPhase
+	{
+		PreUpdate,  ///< Before any Component is updated
+		PostUpdate  ///< After every Component is updated
+	};
+
+	// ================================[ BaseEventQueue ]====================================
+
+	/**
+	* Base polymorphic event queue.
+	* Used for storing different types of event queues in a single container.
+	*/
+	class BaseEventQueue
+	{
+	public:
+		/**
+		* Allow derived queues to have a destructor.
+		*/
+		virtual ~BaseEventQueue() {}
+
+		/**
+		* Make the events emitted since the last swap readable, and start a new frame.
+		*/
+		virtual void swap() = 0;
+
+		/**
+		* Hand the readable events to the listeners of a phase, as a single batch.
+		*
+		* @param phase     The phase whose listeners are run.
+		*/
+		virtual void dispatch(EventPhase phase) = 0;
+
+		/**
+		* Drop all events, both readable and pending.
+		*/
+		virtual void clear() = 0;
+	};
+
+	// ==================================[ EventQueue ]======================================
+
+	/**
+	* Double-buffered queue of a single event type.
+	* Events emitted during a frame are appended to a contiguous pending buffer. When the
+	* frame ends, the buffers are swapped and the whole batch is handed to listeners.
+	*/
+	template <class E>
+	class EventQueue : public BaseEventQueue
+	{
+	public:
+		/// Function consuming a batch of events
+		typedef std::function<void(const std::vector<E>&)> Listener;
+
+		/**
+		* Append an event to the pending buffer.
+		*
+		* @param args      Arguments to feed to the event's constructor.
+		*/
+		template <class ... Args>
+		void emit(Args&& ... args)
+		{
+			m_pending.emplace_back(std::forward<Args>(args)...);
+		}
+
+		/**
+		* Add a listener to a phase.
+		*
+		* @param phase     The phase at which the listener is run.
+		* @param listener  Function consuming a batch of events.
+		*/
+		void listen(EventPhase phase, Listener listener)
+		{
+			m_listeners.push_back(std::make_pair(phase, std::move(listener)));
+		}
+
+		/**
+		* Access the readable events, which were emitted during the previous frame.
+		*
+		* @return          The readable events.
+		*/
+		const std::vector<E>& events() const
+		{
+			return m_current;
+		}
+
+		virtual void swap()
+		{
+			m_current.swap(m_pending);
+			m_pending.clear();  // Keeps its capacity for the next frame
+		}
+
+		virtual void dispatch(EventPhase phase)
+		{
+			if (m_current.empty())
+				return;
+
+			for (size_t i = 0; i < m_listeners.size(); i++)
+				if (m_listeners[i].first == phase)
+					m_listeners[i].second(m_current);
+		}
+
+		virtual void clear()
+		{
+			m_current.clear();
+			m_pending.clear();
+		}
+
+	private:
+		/// Events emitted during the previous frame
+		std::vector<E> m_current;
+
+		/// Events emitted during the current frame
+		std::vector<E> m_pending;
+
+		/// Listeners along with the phase they are run at
+		std::vector<std::pair<EventPhase, Listener>> m_listeners;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_EVENT_HPP
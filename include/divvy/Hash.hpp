@@ -0,0 +1,81 @@
+#ifndef DIVVY_HASH_HPP
+#define DIVVY_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace divvy {
+
+	// =====================================[ Hash ]=========================================
+
+	/**
+	* Deterministic hashing of World state, identical on every platform for the same bytes.
+	* Used to compare the state of Worlds across peers, such as in lockstep multiplayer.
+	*/
+	namespace hash {
+
+		/**
+		* Scramble a 64-bit value, so that nearby values hash far apart (splitmix64).
+		*
+		* @param value     The value to scramble.
+		*
+		* @return          The scrambled value.
+		*/
+		inline uint64_t mix(uint64_t value)
+		{
+			value += 0x9E3779B97F4A7C15ull;
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+			return value ^ (value >> 31);
+		}
+
+		/**
+		* Hash a range of bytes (FNV-1a).
+		*
+		* @param data      The first byte.
+		* @param size      Number of bytes.
+		*
+		* @return          The hash of the bytes.
+		*/
+		inline uint64_t bytes(const void* data, size_t size)
+		{
+			const unsigned char* begin = static_cast<const unsigned char*>(data);
+			uint64_t result = 0xCBF29CE484222325ull;
+
+			for (size_t i = 0; i < size; i++)
+				result = (result ^ begin[i]) * 0x100000001B3ull;
+
+			return result;
+		}
+
+		/**
+		* Combine two hashes, in an order-dependent way.
+		*
+		* @param seed      The hash combined so far.
+		* @param value     The hash to combine into it.
+		*
+		* @return          The combined hash.
+		*/
+		inline uint64_t combine(uint64_t seed, uint64_t value)
+		{
+			return mix(seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)));
+		}
+
+		/**
+		* Hash the state of a single slot of a pool.
+		*
+		* @param index     The EntityID of the slot.
+		* @param value     The hash of the Component in the slot.
+		*
+		* @return          The hash of the slot, never zero in practice.
+		*/
+		inline uint64_t slot(size_t index, uint64_t value)
+		{
+			return mix(static_cast<uint64_t>(index) ^ mix(value));
+		}
+
+	} // namespace hash
+
+} // namespace divvy
+
+#endif // DIVVY_HASH_HPP
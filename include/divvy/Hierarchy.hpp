@@ -0,0 +1,201 @@
+#ifndef DIVVY_HIERARCHY_HPP
+#define DIVVY_HIERARCHY_HPP
+
+#include <stdexcept>
+#include <vector>
+
+namespace divvy {
+
+	// ===================================[ Hierarchy ]======================================
+
+	/**
+	* Hierarchy stores the parent/child relationships between the Entities of a World.
+	* Links are kept in pools indexed by EntityID (parent, first child, and siblings), and
+	* a breadth-first ordering of all linked Entities is cached, so that parents are
+	* always visited before their children in a single linear sweep.
+	*/
+	class Hierarchy
+	{
+	public:
+		/// Marks the absence of a linked Entity
+		static const size_t npos = static_cast<size_t>(-1);
+
+		/**
+		* Attach an Entity to a parent, detaching it from its previous parent first.
+		*
+		* @param child     The EntityID of the child.
+		* @param parent    The EntityID of the parent.
+		*/
+		void attach(size_t child, size_t parent)
+		{
+			if (child >= m_parent.size() || parent >= m_parent.size())
+				throw std::runtime_error("Hierarchy index out of bounds");
+
+			// Walk up from the parent to make sure no cycle is created
+			for (size_t it = parent; it != npos; it = m_parent[it])
+				if (it == child)
+					throw std::runtime_error("Cannot parent an Entity to itself or its descendant");
+
+			detach(child);
+
+			m_parent[child] = parent;
+			m_prevSibling[child] = npos;
+			m_nextSibling[child] = m_firstChild[parent];
+
+			if (m_firstChild[parent] != npos)
+				m_prevSibling[m_firstChild[parent]] = child;
+
+			m_firstChild[parent] = child;
+			m_dirty = true;
+		}
+
+		/**
+		* Detach an Entity from its parent. Its own children stay attached to it.
+		*
+		* @param child     The EntityID of the child.
+		*/
+		void detach(size_t child)
+		{
+			if (child >= m_parent.size() || m_parent[child] == npos)
+				return;
+
+			if (m_prevSibling[child] != npos)
+				m_nextSibling[m_prevSibling[child]] = m_nextSibling[child];
+			else
+				m_firstChild[m_parent[child]] = m_nextSibling[child];
+
+			if (m_nextSibling[child] != npos)
+				m_prevSibling[m_nextSibling[child]] = m_prevSibling[child];
+
+			m_parent[child] = npos;
+			m_prevSibling[child] = npos;
+			m_nextSibling[child] = npos;
+			m_dirty = true;
+		}
+
+		/**
+		* Unlink an Entity entirely, turning its children into roots.
+		*
+		* @param index     The EntityID of the Entity.
+		*/
+		void unlink(size_t index)
+		{
+			if (index >= m_parent.size())
+				return;
+
+			detach(index);
+
+			while (m_firstChild[index] != npos)
+				detach(m_firstChild[index]);
+		}
+
+		/**
+		* Retrieve the parent of an Entity.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          EntityID of the parent, or npos if there is none.
+		*/
+		size_t parent(size_t index) const
+		{
+			return index < m_parent.size() ? m_parent[index] : npos;
+		}
+
+		/**
+		* Collect an Entity and all of its descendants, in breadth-first order.
+		*
+		* @param index     The EntityID of the subtree's root.
+		*
+		* @return          EntityIDs of the subtree, starting with the root.
+		*/
+		std::vector<size_t> subtree(size_t index) const
+		{
+			std::vector<size_t> nodes(1, index);
+
+			for (size_t i = 0; i < nodes.size(); i++)
+				for (size_t child = m_firstChild[nodes[i]]; child != npos; child = m_nextSibling[child])
+					nodes.push_back(child);
+
+			return nodes;
+		}
+
+		/**
+		* Retrieve every linked Entity in breadth-first order, rebuilding the order only
+		* when links changed since the last call.
+		*
+		* @return          EntityIDs where every parent precedes its children.
+		*/
+		const std::vector<size_t>& order()
+		{
+			if (m_dirty)
+			{
+				m_order.clear();
+
+				for (size_t root = 0; root < m_parent.size(); root++)
+					if (m_parent[root] == npos && m_firstChild[root] != npos)
+						m_order.push_back(root);
+
+				for (size_t i = 0; i < m_order.size(); i++)
+					for (size_t child = m_firstChild[m_order[i]]; child != npos; child = m_nextSibling[child])
+						m_order.push_back(child);
+
+				m_dirty = false;
+			}
+
+			return m_order;
+		}
+
+		/**
+		* Resize the link pools to allow for more Entities.
+		*
+		* @param size      The desired amount of Entities.
+		*/
+		void resize(size_t size)
+		{
+			for (size_t i = size; i < m_parent.size(); i++)
+				unlink(i);
+
+			size_t none = npos;
+
+			m_parent.resize(size, none);
+			m_firstChild.resize(size, none);
+			m_nextSibling.resize(size, none);
+			m_prevSibling.resize(size, none);
+		}
+
+		/**
+		* Remove all links.
+		*/
+		void clear()
+		{
+			m_parent.clear();
+			m_firstChild.clear();
+			m_nextSibling.clear();
+			m_prevSibling.clear();
+			m_order.clear();
+			m_dirty = false;
+		}
+
+	private:
+		/// Parent of every Entity
+		std::vector<size_t> m_parent;
+
+		/// First child of every Entity
+		std::vector<size_t> m_firstChild;
+
+		/// Next sibling of every Entity
+		std::vector<size_t> m_nextSibling;
+
+		/// Previous sibling of every Entity, for constant time detaching
+		std::vector<size_t> m_prevSibling;
+
+		/// Cached breadth-first order of all linked Entities
+		std::vector<size_t> m_order;
+
+		/// Whether the cached order is out of date
+		bool m_dirty = false;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_HIERARCHY_HPP
@@ -0,0 +1,104 @@
+#ifndef DIVVY_HISTORY_HPP
+#define DIVVY_HISTORY_HPP
+
+#include <vector>
+
+#include "ComponentPool.hpp"
+
+namespace divvy {
+
+	// ==================================[ BaseHistory ]=====================================
+
+	/**
+	* Base polymorphic history.
+	* Used for storing the histories of different Component types in a single container.
+	*/
+	class BaseHistory
+	{
+	public:
+		/**
+		* Allow derived histories to have a destructor.
+		*/
+		virtual ~BaseHistory() {}
+
+		/**
+		* Keep the current values of every Component as the previous values.
+		*/
+		virtual void save() = 0;
+	};
+
+	// ====================================[ History ]=======================================
+
+	/**
+	* The values a Component type had before the last fixed step.
+	* Along with the current values in the pool, this double-buffers the Components so
+	* rendering can interpolate between two simulated states.
+	*/
+	template <class T>
+	class History : public BaseHistory
+	{
+	public:
+		/**
+		* Create a history of the Components of a pool.
+		*
+		* @param pool      The pool holding the Components.
+		*/
+		History(pool_type<T>& pool)
+			: m_pool(pool)
+		{
+			save();
+		}
+
+		virtual void save()
+		{
+			m_values.resize(m_pool.capacity());
+			m_saved.assign(m_pool.capacity(), false);
+
+			for (size_t i = 0; i < m_pool.capacity(); i++)
+			{
+				if (m_pool.has(i))
+				{
+					m_values[i] = constPool().get(i);
+					m_saved[i] = true;
+				}
+			}
+		}
+
+		/**
+		* Retrieve the value a Component had before the last fixed step. Components added
+		* since then have no previous value, so their current value is returned instead.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          The previous value of the Component.
+		*/
+		const T& previous(size_t index) const
+		{
+			if (index < m_saved.size() && m_saved[index])
+				return m_values[index];
+
+			return constPool().get(index);
+		}
+
+	private:
+		/**
+		* Read the pool without marking its Components as written to.
+		*/
+		const pool_type<T>& constPool() const
+		{
+			return m_pool;
+		}
+
+		/// The pool holding the current values
+		pool_type<T>& m_pool;
+
+		/// Previous value of every Component
+		std::vector<T> m_values;
+
+		/// Whether an Entity had the Component before the last fixed step
+		std::vector<bool> m_saved;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_HISTORY_HPP
@@ -0,0 +1,257 @@
+#ifndef DIVVY_INDEX_HPP
+#define DIVVY_INDEX_HPP
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "ComponentPool.hpp"
+
+namespace divvy {
+
+	// ==================================[ BasicIndex ]======================================
+
+	/**
+	* Secondary index over a value extracted from a Component, such as a name or a team.
+	* The index follows the changes of the Component's pool and only re-extracts the
+	* values of changed Entities, right before it is queried.
+	*
+	* Changes made through Entity::add(), Entity::get(), Entity::mutate(), Accessors, and
+	* removal are tracked per Entity, while Entity::read() counts as no change. Spans and
+	* the updates of types that have any make the next query re-extract every value.
+	*/
+	template <class T, class Key, class Map>
+	class BasicIndex : public ChangeListener
+	{
+	public:
+		typedef T   component_type;
+		typedef Key key_type;
+
+		/// Function extracting the indexed value from a Component
+		typedef std::function<Key(const T&)> Extractor;
+
+		/**
+		* Create an index over every Component of a pool.
+		*
+		* @param pool      The pool holding the indexed Components.
+		* @param extract   Function extracting the indexed value from a Component.
+		*/
+		BasicIndex(pool_type<T>& pool, Extractor extract)
+			: m_pool(pool), m_extract(extract)
+		{
+			for (size_t i = 0; i < pool.capacity(); i++)
+				if (pool.has(i))
+					changed(i);
+		}
+
+		virtual void changed(size_t index)
+		{
+			if (index >= m_pending.size())
+				m_pending.resize(index + 1, false);
+
+			if (!m_pending[index])
+			{
+				m_pending[index] = true;
+				m_dirty.push_back(index);
+			}
+		}
+
+		virtual void changedAll()
+		{
+			m_stale = true;
+		}
+
+		/**
+		* Find every Entity whose Component has the given value.
+		*
+		* @param key       The value to look for.
+		*
+		* @return          EntityIDs of the matching Entities.
+		*/
+		const std::vector<size_t>& find(const Key& key)
+		{
+			refresh();
+
+			auto it = m_map.find(key);
+			return it == m_map.end() ? m_none : it->second;
+		}
+
+		/**
+		* Count the Entities whose Component has the given value.
+		*
+		* @param key       The value to look for.
+		*
+		* @return          Number of matching Entities.
+		*/
+		size_t count(const Key& key)
+		{
+			return find(key).size();
+		}
+
+	protected:
+		/**
+		* Re-extract the values of every Entity that changed since the last query.
+		*/
+		void refresh()
+		{
+			if (m_stale)
+			{
+				m_stale = false;
+
+				for (size_t i = 0; i < m_pool.capacity(); i++)
+					changed(i);
+			}
+
+			for (size_t i = 0; i < m_dirty.size(); i++)
+			{
+				size_t index = m_dirty[i];
+				m_pending[index] = false;
+
+				erase(index);
+
+				if (m_pool.has(index))
+					insert(index, m_extract(static_cast<const pool_type<T>&>(m_pool).get(index)));
+			}
+
+			m_dirty.clear();
+		}
+
+		/// Values mapped to the Entities that have them
+		Map m_map;
+
+	private:
+		/**
+		* Add an Entity under a value.
+		*/
+		void insert(size_t index, Key key)
+		{
+			if (index >= m_keys.size())
+			{
+				m_keys.resize(index + 1);
+				m_position.resize(index + 1, npos());
+			}
+
+			std::vector<size_t>& entities = m_map[key];
+
+			m_position[index] = entities.size();
+			entities.push_back(index);
+			m_keys[index] = std::move(key);
+		}
+
+		/**
+		* Remove an Entity from under its current value, if it has one.
+		*/
+		void erase(size_t index)
+		{
+			if (index >= m_position.size() || m_position[index] == npos())
+				return;
+
+			auto it = m_map.find(m_keys[index]);
+			std::vector<size_t>& entities = it->second;
+
+			// Swap the last Entity into the released position
+			size_t last = entities.back();
+			entities[m_position[index]] = last;
+			m_position[last] = m_position[index];
+			entities.pop_back();
+
+			if (entities.empty())
+				m_map.erase(it);
+
+			m_position[index] = npos();
+			m_keys[index] = Key();
+		}
+
+		/// Marks an Entity that isn't indexed
+		static size_t npos()
+		{
+			return static_cast<size_t>(-1);
+		}
+
+		/// The pool holding the indexed Components
+		pool_type<T>& m_pool;
+
+		/// Function extracting the indexed value from a Component
+		Extractor m_extract;
+
+		/// Indexed value of every Entity
+		std::vector<Key> m_keys;
+
+		/// Position of every Entity within the Entities of its value
+		std::vector<size_t> m_position;
+
+		/// Entities that changed since the last query
+		std::vector<size_t> m_dirty;
+
+		/// Whether an Entity is already queued in m_dirty
+		std::vector<bool> m_pending;
+
+		/// Whether any Entity may have changed without being queued
+		bool m_stale = false;
+
+		/// Returned for values without Entities
+		std::vector<size_t> m_none;
+	};
+
+	// ===================================[ HashIndex ]======================================
+
+	/**
+	* Index for equality lookups, such as finding an Entity by name or player ID.
+	* The value type has to be hashable through std::hash.
+	*/
+	template <class T, class Key>
+	class HashIndex : public BasicIndex<T, Key, std::unordered_map<Key, std::vector<size_t>>>
+	{
+	public:
+		typedef BasicIndex<T, Key, std::unordered_map<Key, std::vector<size_t>>> Base;
+
+		HashIndex(pool_type<T>& pool, typename Base::Extractor extract)
+			: Base(pool, extract)
+		{
+		}
+	};
+
+	// ==================================[ OrderedIndex ]====================================
+
+	/**
+	* Index for equality and range lookups, such as finding every Entity within a level
+	* range. The value type has to be comparable through operator<.
+	*/
+	template <class T, class Key>
+	class OrderedIndex : public BasicIndex<T, Key, std::map<Key, std::vector<size_t>>>
+	{
+	public:
+		typedef BasicIndex<T, Key, std::map<Key, std::vector<size_t>>> Base;
+
+		OrderedIndex(pool_type<T>& pool, typename Base::Extractor extract)
+			: Base(pool, extract)
+		{
+		}
+
+		/**
+		* Run a function on every Entity whose value lies within a range, in value order.
+		*
+		* @param low       The lowest value included.
+		* @param high      The highest value included.
+		* @param fn        Function taking (size_t index).
+		*/
+		template <class Func>
+		void range(const Key& low, const Key& high, Func fn)
+		{
+			this->refresh();
+
+			if (high < low)
+				return;
+
+			auto end = this->m_map.upper_bound(high);
+
+			for (auto it = this->m_map.lower_bound(low); it != end; it++)
+				for (size_t i = 0; i < it->second.size(); i++)
+					fn(it->second[i]);
+		}
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_INDEX_HPP
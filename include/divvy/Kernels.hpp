@@ -0,0 +1,607 @@
+#ifndef DIVVY_KERNELS_HPP
+#define DIVVY_KERNELS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <vector>
+
+#include "Allocator.hpp"
+
+/**
+* SIMD kernels are compiled for x86 with SSE2 as the baseline, along with AVX2 versions
+* on compilers that allow enabling it per function. Define DIVVY_NO_SIMD before
+* including this header to only build the scalar versions.
+*/
+#if !defined(DIVVY_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)))
+#define DIVVY_SIMD_SSE2
+#include <emmintrin.h>
+
+#if defined(__GNUC__)
+#define DIVVY_SIMD_AVX2
+#define DIVVY_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+namespace divvy {
+namespace simd {
+
+	/**
+	* The instruction sets kernels can run with, from least to most capable.
+	*/
+	enum class Level
+	{
+		Scalar,  ///< Plain C++, always available
+		SSE2,    ///< 4 floats at once
+		AVX2     ///< 8 floats at once
+	};
+
+	/**
+	* Find the most capable instruction set supported by both the build and the CPU.
+	*
+	* @return          The most capable instruction set.
+	*/
+	inline Level detect()
+	{
+#ifdef DIVVY_SIMD_AVX2
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx2"))
+			return Level::AVX2;
+#endif
+#ifdef DIVVY_SIMD_SSE2
+		return Level::SSE2;
+#else
+		return Level::Scalar;
+#endif
+	}
+
+	/**
+	* The instruction set kernels currently run with, detected on first use. Atomic, since
+	* kernels may run on several threads while the level is changed.
+	*/
+	inline std::atomic<Level>& active()
+	{
+		static std::atomic<Level> level(detect());
+		return level;
+	}
+
+	/**
+	* Retrieve the instruction set kernels currently run with.
+	*
+	* @return          The active instruction set.
+	*/
+	inline Level level()
+	{
+		return active().load(std::memory_order_relaxed);
+	}
+
+	/**
+	* Limit the instruction set kernels run with, such as for comparing results between
+	* instruction sets. Instruction sets beyond the supported ones are never used.
+	*
+	* @param level     The most capable instruction set to use.
+	*/
+	inline void setLevel(Level level)
+	{
+		Level supported = detect();
+		active().store(level < supported ? level : supported, std::memory_order_relaxed);
+	}
+
+	/**
+	* Check whether every address is aligned, such as to take the aligned path of a kernel.
+	*
+	* @param alignment The alignment in bytes.
+	* @param addresses The addresses to check.
+	*
+	* @return          True if all are aligned, false otherwise.
+	*/
+	inline bool aligned(size_t alignment, std::initializer_list<const void*> addresses)
+	{
+		for (const void* address : addresses)
+			if (reinterpret_cast<uintptr_t>(address) % alignment)
+				return false;
+
+		return true;
+	}
+
+	// ===================================[ Scalar ]=========================================
+
+	namespace scalar {
+
+		inline void integrate(float* position, const float* velocity, float dt, size_t begin, size_t count)
+		{
+			for (size_t i = begin; i < count; i++)
+				position[i] += velocity[i] * dt;
+		}
+
+		inline void clamp(float* values, float low, float high, size_t begin, size_t count)
+		{
+			for (size_t i = begin; i < count; i++)
+				values[i] = values[i] < low ? low : (values[i] > high ? high : values[i]);  // Keeps NaN
+		}
+
+		inline void bounds(const float* center, const float* extent, float* low, float* high, size_t begin, size_t count)
+		{
+			for (size_t i = begin; i < count; i++)
+			{
+				low[i] = center[i] - extent[i];
+				high[i] = center[i] + extent[i];
+			}
+		}
+
+		inline void cull(const float* x, const float* y, float cx, float cy, float radius,
+			size_t begin, size_t count, std::vector<size_t>& visible)
+		{
+			float squared = radius * radius;
+
+			for (size_t i = begin; i < count; i++)
+			{
+				float dx = x[i] - cx, dy = y[i] - cy;
+
+				if (dx * dx + dy * dy <= squared)
+					visible.push_back(i);
+			}
+		}
+
+	} // namespace scalar
+
+	// ====================================[ SSE2 ]==========================================
+
+#ifdef DIVVY_SIMD_SSE2
+	namespace sse2 {
+
+		/**
+		* Loads and stores of 16-byte aligned addresses.
+		*/
+		struct Aligned
+		{
+			static __m128 load(const float* from) { return _mm_load_ps(from); }
+			static void store(float* to, __m128 value) { _mm_store_ps(to, value); }
+		};
+
+		/**
+		* Loads and stores of any address.
+		*/
+		struct Unaligned
+		{
+			static __m128 load(const float* from) { return _mm_loadu_ps(from); }
+			static void store(float* to, __m128 value) { _mm_storeu_ps(to, value); }
+		};
+
+		template <class Access>
+		inline size_t integrate(float* position, const float* velocity, float dt, size_t count)
+		{
+			__m128 step = _mm_set1_ps(dt);
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 p = Access::load(position + i);
+				__m128 v = Access::load(velocity + i);
+				Access::store(position + i, _mm_add_ps(p, _mm_mul_ps(v, step)));
+			}
+
+			return i;
+		}
+
+		inline size_t integrate(float* position, const float* velocity, float dt, size_t count)
+		{
+			return aligned(16, {position, velocity}) ? integrate<Aligned>(position, velocity, dt, count)
+				: integrate<Unaligned>(position, velocity, dt, count);
+		}
+
+		template <class Access>
+		inline size_t clamp(float* values, float low, float high, size_t count)
+		{
+			__m128 lo = _mm_set1_ps(low), hi = _mm_set1_ps(high);
+			size_t i = 0;
+
+			// Min and max return their second operand for NaN, which keeps NaN like scalar code
+			for (; i + 4 <= count; i += 4)
+				Access::store(values + i, _mm_min_ps(hi, _mm_max_ps(lo, Access::load(values + i))));
+
+			return i;
+		}
+
+		inline size_t clamp(float* values, float low, float high, size_t count)
+		{
+			return aligned(16, {values}) ? clamp<Aligned>(values, low, high, count)
+				: clamp<Unaligned>(values, low, high, count);
+		}
+
+		template <class Access>
+		inline size_t bounds(const float* center, const float* extent, float* low, float* high, size_t count)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 c = Access::load(center + i);
+				__m128 e = Access::load(extent + i);
+				Access::store(low + i, _mm_sub_ps(c, e));
+				Access::store(high + i, _mm_add_ps(c, e));
+			}
+
+			return i;
+		}
+
+		inline size_t bounds(const float* center, const float* extent, float* low, float* high, size_t count)
+		{
+			return aligned(16, {center, extent, low, high}) ? bounds<Aligned>(center, extent, low, high, count)
+				: bounds<Unaligned>(center, extent, low, high, count);
+		}
+
+		template <class Access>
+		inline size_t cull(const float* x, const float* y, float cx, float cy, float radius,
+			size_t count, std::vector<size_t>& visible)
+		{
+			__m128 px = _mm_set1_ps(cx), py = _mm_set1_ps(cy), squared = _mm_set1_ps(radius * radius);
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 dx = _mm_sub_ps(Access::load(x + i), px);
+				__m128 dy = _mm_sub_ps(Access::load(y + i), py);
+				__m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+				int mask = _mm_movemask_ps(_mm_cmple_ps(distance, squared));
+
+				for (int bit = 0; mask; bit++, mask >>= 1)
+					if (mask & 1)
+						visible.push_back(i + bit);
+			}
+
+			return i;
+		}
+
+		inline size_t cull(const float* x, const float* y, float cx, float cy, float radius,
+			size_t count, std::vector<size_t>& visible)
+		{
+			return aligned(16, {x, y}) ? cull<Aligned>(x, y, cx, cy, radius, count, visible)
+				: cull<Unaligned>(x, y, cx, cy, radius, count, visible);
+		}
+
+	} // namespace sse2
+#endif
+
+	// ====================================[ AVX2 ]==========================================
+
+#ifdef DIVVY_SIMD_AVX2
+	namespace avx2 {
+
+		/**
+		* Loads and stores of 32-byte aligned addresses.
+		*/
+		struct Aligned
+		{
+			DIVVY_TARGET_AVX2 static __m256 load(const float* from) { return _mm256_load_ps(from); }
+			DIVVY_TARGET_AVX2 static void store(float* to, __m256 value) { _mm256_store_ps(to, value); }
+		};
+
+		/**
+		* Loads and stores of any address.
+		*/
+		struct Unaligned
+		{
+			DIVVY_TARGET_AVX2 static __m256 load(const float* from) { return _mm256_loadu_ps(from); }
+			DIVVY_TARGET_AVX2 static void store(float* to, __m256 value) { _mm256_storeu_ps(to, value); }
+		};
+
+		template <class Access>
+		DIVVY_TARGET_AVX2 inline size_t integrate(float* position, const float* velocity, float dt, size_t count)
+		{
+			__m256 step = _mm256_set1_ps(dt);
+			size_t i = 0;
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 p = Access::load(position + i);
+				__m256 v = Access::load(velocity + i);
+				Access::store(position + i, _mm256_add_ps(p, _mm256_mul_ps(v, step)));
+			}
+
+			return i;
+		}
+
+		inline size_t integrate(float* position, const float* velocity, float dt, size_t count)
+		{
+			return aligned(32, {position, velocity}) ? integrate<Aligned>(position, velocity, dt, count)
+				: integrate<Unaligned>(position, velocity, dt, count);
+		}
+
+		template <class Access>
+		DIVVY_TARGET_AVX2 inline size_t clamp(float* values, float low, float high, size_t count)
+		{
+			__m256 lo = _mm256_set1_ps(low), hi = _mm256_set1_ps(high);
+			size_t i = 0;
+
+			// Min and max return their second operand for NaN, which keeps NaN like scalar code
+			for (; i + 8 <= count; i += 8)
+				Access::store(values + i, _mm256_min_ps(hi, _mm256_max_ps(lo, Access::load(values + i))));
+
+			return i;
+		}
+
+		inline size_t clamp(float* values, float low, float high, size_t count)
+		{
+			return aligned(32, {values}) ? clamp<Aligned>(values, low, high, count)
+				: clamp<Unaligned>(values, low, high, count);
+		}
+
+		template <class Access>
+		DIVVY_TARGET_AVX2 inline size_t bounds(const float* center, const float* extent, float* low, float* high, size_t count)
+		{
+			size_t i = 0;
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 c = Access::load(center + i);
+				__m256 e = Access::load(extent + i);
+				Access::store(low + i, _mm256_sub_ps(c, e));
+				Access::store(high + i, _mm256_add_ps(c, e));
+			}
+
+			return i;
+		}
+
+		inline size_t bounds(const float* center, const float* extent, float* low, float* high, size_t count)
+		{
+			return aligned(32, {center, extent, low, high}) ? bounds<Aligned>(center, extent, low, high, count)
+				: bounds<Unaligned>(center, extent, low, high, count);
+		}
+
+		template <class Access>
+		DIVVY_TARGET_AVX2 inline size_t cull(const float* x, const float* y, float cx, float cy, float radius,
+			size_t count, std::vector<size_t>& visible)
+		{
+			__m256 px = _mm256_set1_ps(cx), py = _mm256_set1_ps(cy), squared = _mm256_set1_ps(radius * radius);
+			size_t i = 0;
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 dx = _mm256_sub_ps(Access::load(x + i), px);
+				__m256 dy = _mm256_sub_ps(Access::load(y + i), py);
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+				int mask = _mm256_movemask_ps(_mm256_cmp_ps(distance, squared, _CMP_LE_OQ));
+
+				for (int bit = 0; mask; bit++, mask >>= 1)
+					if (mask & 1)
+						visible.push_back(i + bit);
+			}
+
+			return i;
+		}
+
+		inline size_t cull(const float* x, const float* y, float cx, float cy, float radius,
+			size_t count, std::vector<size_t>& visible)
+		{
+			return aligned(32, {x, y}) ? cull<Aligned>(x, y, cx, cy, radius, count, visible)
+				: cull<Unaligned>(x, y, cx, cy, radius, count, visible);
+		}
+
+	} // namespace avx2
+#endif
+
+	// ===================================[ Kernels ]========================================
+
+	/**
+	* Move positions along their velocities: position += velocity * dt.
+	*
+	* @param position  The positions to move, along a single axis.
+	* @param velocity  The velocities, along the same axis.
+	* @param dt        Seconds to move for.
+	* @param count     Number of elements.
+	*/
+	inline void integrate(float* position, const float* velocity, float dt, size_t count)
+	{
+		size_t done = 0;
+
+		switch (level())
+		{
+#ifdef DIVVY_SIMD_AVX2
+		case Level::AVX2: done = avx2::integrate(position, velocity, dt, count); break;
+#endif
+#ifdef DIVVY_SIMD_SSE2
+		case Level::SSE2: done = sse2::integrate(position, velocity, dt, count); break;
+#endif
+		default: break;
+		}
+
+		scalar::integrate(position, velocity, dt, done, count);
+	}
+
+	/**
+	* Clamp values to a range. Values that are not a number stay so, with every
+	* instruction set.
+	*
+	* @param values    The values to clamp.
+	* @param low       The lowest value allowed.
+	* @param high      The highest value allowed.
+	* @param count     Number of elements.
+	*/
+	inline void clamp(float* values, float low, float high, size_t count)
+	{
+		size_t done = 0;
+
+		switch (level())
+		{
+#ifdef DIVVY_SIMD_AVX2
+		case Level::AVX2: done = avx2::clamp(values, low, high, count); break;
+#endif
+#ifdef DIVVY_SIMD_SSE2
+		case Level::SSE2: done = sse2::clamp(values, low, high, count); break;
+#endif
+		default: break;
+		}
+
+		scalar::clamp(values, low, high, done, count);
+	}
+
+	/**
+	* Update axis-aligned bounding boxes from their centers and half extents, along a
+	* single axis: low = center - extent, high = center + extent.
+	*
+	* @param center    The centers of the boxes.
+	* @param extent    The half extents of the boxes.
+	* @param low       Receives the lowest coordinates of the boxes.
+	* @param high      Receives the highest coordinates of the boxes.
+	* @param count     Number of elements.
+	*/
+	inline void bounds(const float* center, const float* extent, float* low, float* high, size_t count)
+	{
+		size_t done = 0;
+
+		switch (level())
+		{
+#ifdef DIVVY_SIMD_AVX2
+		case Level::AVX2: done = avx2::bounds(center, extent, low, high, count); break;
+#endif
+#ifdef DIVVY_SIMD_SSE2
+		case Level::SSE2: done = sse2::bounds(center, extent, low, high, count); break;
+#endif
+		default: break;
+		}
+
+		scalar::bounds(center, extent, low, high, done, count);
+	}
+
+	/**
+	* Collect the points within a radius of a center, such as for visibility culling.
+	*
+	* @param x         The horizontal coordinates of the points.
+	* @param y         The vertical coordinates of the points.
+	* @param cx        The horizontal coordinate of the center of the circle.
+	* @param cy        The vertical coordinate of the center of the circle.
+	* @param radius    The radius of the circle.
+	* @param count     Number of elements.
+	* @param visible   The indexes of the points within the circle are appended to this,
+	*                  in ascending order.
+	*/
+	inline void cull(const float* x, const float* y, float cx, float cy, float radius,
+		size_t count, std::vector<size_t>& visible)
+	{
+		size_t done = 0;
+
+		switch (level())
+		{
+#ifdef DIVVY_SIMD_AVX2
+		case Level::AVX2: done = avx2::cull(x, y, cx, cy, radius, count, visible); break;
+#endif
+#ifdef DIVVY_SIMD_SSE2
+		case Level::SSE2: done = sse2::cull(x, y, cx, cy, radius, count, visible); break;
+#endif
+		default: break;
+		}
+
+		scalar::cull(x, y, cx, cy, radius, done, count, visible);
+	}
+
+	// ====================================[ Gather ]========================================
+
+	/**
+	* Lets kernels run over the Components handed out by World::spans(). Components are
+	* stored whole, one after the other, so the kernels can't run over their members in
+	* place. A Gather copies float members of a span into arrays of their own, aligned to
+	* the vector width so that kernels take aligned loads and stores, and copies the
+	* members that kernels wrote back into the Components.
+	*
+	*    world.spans<Particle>([&](Particle* begin, Particle* end)
+	*    {
+	*        simd::Gather<Particle> span(begin, end);
+	*        simd::integrate(span(&Particle::x), span(&Particle::vx), dt, span.size());
+	*        span.scatter(&Particle::x);
+	*    });
+	*/
+	template <class T>
+	class Gather
+	{
+	public:
+		/// A float member of the Component type
+		typedef float T::* Member;
+
+		/**
+		* Start gathering the members of a span of Components.
+		*
+		* @param begin     The first Component of the span.
+		* @param end       One past the last Component of the span.
+		*/
+		Gather(T* begin, T* end)
+			: m_begin(begin), m_size(static_cast<size_t>(end - begin))
+		{
+		}
+
+		/**
+		* Retrieve the number of Components of the span.
+		*
+		* @return          Number of Components.
+		*/
+		size_t size() const
+		{
+			return m_size;
+		}
+
+		/**
+		* Retrieve the array of a member, gathering it on first use. The array stays valid
+		* as long as the Gather.
+		*
+		* @param member    The member to gather.
+		*
+		* @return          The value of the member for every Component of the span.
+		*/
+		float* operator()(Member member)
+		{
+			for (size_t i = 0; i < m_fields.size(); i++)
+				if (m_fields[i].member == member)
+					return m_fields[i].values.data();
+
+			m_fields.push_back(Field());
+			Field& field = m_fields.back();
+			field.member = member;
+			field.values.resize(m_size);
+
+			for (size_t i = 0; i < m_size; i++)
+				field.values[i] = m_begin[i].*member;
+
+			return field.values.data();
+		}
+
+		/**
+		* Copy the array of a member back into the Components.
+		*
+		* @param member    The member to copy back, gathered beforehand.
+		*/
+		void scatter(Member member)
+		{
+			const float* values = (*this)(member);
+
+			for (size_t i = 0; i < m_size; i++)
+				m_begin[i].*member = values[i];
+		}
+
+	private:
+		/**
+		* A gathered member.
+		*/
+		struct Field
+		{
+			Member member = nullptr;
+			std::vector<float, AlignedAllocator<float, 32>> values;
+		};
+
+		/// The first Component of the span
+		T* m_begin;
+
+		/// Number of Components of the span
+		size_t m_size;
+
+		/// The members gathered, which never move once gathered
+		std::deque<Field> m_fields;
+	};
+
+} // namespace simd
+} // namespace divvy
+
+#endif // DIVVY_KERNELS_HPP
@@ -0,0 +1,324 @@
+#ifndef DIVVY_LOG_HPP
+#define DIVVY_LOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+
+#ifdef DIVVY_DEBUG
+#include <iostream>
+#endif
+
+/**
+* The most verbose level of log records that is compiled in.
+*    0 - Nothing, every log statement is compiled out
+*    1 - Errors
+*    2 - Warnings
+*    3 - Info
+*    4 - Debug (default when DIVVY_DEBUG is defined)
+*
+* Define before including divvy.hpp to choose a level.
+*/
+#ifndef DIVVY_LOG_LEVEL
+#ifdef DIVVY_DEBUG
+#define DIVVY_LOG_LEVEL 4
+#else
+#define DIVVY_LOG_LEVEL 0
+#endif
+#endif
+
+/**
+* Log a record at a level, if the level is compiled in. The arguments are not
+* evaluated at all when it isn't.
+*/
+#if DIVVY_LOG_LEVEL > 0
+#define DIVVY_LOG(level, message, detail, entity) \
+	do { \
+		if (static_cast<int>(divvy::LogLevel::level) <= DIVVY_LOG_LEVEL) \
+			divvy::log(divvy::LogLevel::level, message, detail, entity); \
+	} while (false)
+#else
+#define DIVVY_LOG(level, message, detail, entity) ((void)0)
+#endif
+
+namespace divvy {
+
+	/**
+	* The severity of a log record.
+	*/
+	enum class LogLevel
+	{
+		Error = 1,  ///< Misuse that was recovered from
+		Warning,    ///< Operations without effect, such as removing twice
+		Info,       ///< Registration of Component types
+		Debug       ///< Every Entity and Component operation
+	};
+
+	/**
+	* A single structured log record. Only pointers to static strings are stored, so
+	* recording never allocates or formats.
+	*/
+	struct LogRecord
+	{
+		/// The severity of the record
+		LogLevel level = LogLevel::Debug;
+
+		/// What happened, as a static string
+		const char* message = "";
+
+		/// Additional static string, such as the name of a Component type
+		const char* detail = "";
+
+		/// The EntityID involved, or LogRecord::none()
+		size_t entity = none();
+
+		/// Marks a record without an Entity
+		static size_t none()
+		{
+			return static_cast<size_t>(-1);
+		}
+	};
+
+	/**
+	* Display a log record to a standard output stream.
+	*
+	* @param   stream      The stream to ouput to.
+	* @param   record      The record to display.
+	*
+	* @return              Returns stream for further usage.
+	*/
+	inline std::ostream& operator<<(std::ostream& stream, const LogRecord& record)
+	{
+		static const char* names[] = {"", "ERROR", "WARNING", "INFO", "DEBUG"};
+
+		stream << "-- " << names[static_cast<int>(record.level)] << ": " << record.message;
+
+		if (*record.detail)
+			stream << " " << record.detail;
+
+		if (record.entity != LogRecord::none())
+			stream << " (Entity #" << record.entity << ")";
+
+		return stream;
+	}
+
+	// ====================================[ LogSink ]=======================================
+
+	/**
+	* Base polymorphic destination of log records.
+	* Derive from this class to forward records elsewhere, such as to a file or an
+	* engine's console.
+	*/
+	class LogSink
+	{
+	public:
+		/**
+		* Allow derived sinks to have a destructor.
+		*/
+		virtual ~LogSink() {}
+
+		/**
+		* Receive a log record.
+		*
+		* @param record    The record to receive.
+		*/
+		virtual void write(const LogRecord& record) = 0;
+	};
+
+	// ===================================[ StreamSink ]=====================================
+
+	/**
+	* Sink writing every record to a stream as a line of text, without flushing.
+	*/
+	class StreamSink : public LogSink
+	{
+	public:
+		StreamSink(std::ostream& stream) : m_stream(stream) {}
+
+		virtual void write(const LogRecord& record)
+		{
+			m_stream << record << '\n';
+		}
+
+	private:
+		/// The stream written to
+		std::ostream& m_stream;
+	};
+
+	// ====================================[ RingLog ]=======================================
+
+	/**
+	* Sink keeping the latest records in a fixed-size ring buffer, overwriting the oldest.
+	* Writing is lock-free and never allocates, so it is cheap enough to leave enabled at
+	* production Entity counts. Every slot carries a sequence number, so records that
+	* were overwritten or are still being written while draining are skipped.
+	*/
+	class RingLog : public LogSink
+	{
+	public:
+		/**
+		* Create a ring buffer.
+		*
+		* @param capacity  Number of records kept, rounded up to a power of two.
+		*/
+		RingLog(size_t capacity = 4096)
+		{
+			size_t size = 1;
+
+			while (size < capacity)
+				size <<= 1;
+
+			m_mask = size - 1;
+			m_slots.reset(new Slot[size]);
+		}
+
+		virtual void write(const LogRecord& record)
+		{
+			size_t ticket = m_head.fetch_add(1, std::memory_order_relaxed);
+			Slot& slot = m_slots[ticket & m_mask];
+
+			slot.sequence.store(0, std::memory_order_relaxed);   // Being written
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.record = record;
+			slot.sequence.store(ticket + 1, std::memory_order_release);
+		}
+
+		/**
+		* Hand every record kept to a function, oldest first, and forget them.
+		*
+		* @param fn        Function taking (const LogRecord& record).
+		*/
+		template <class Func>
+		void drain(Func fn)
+		{
+			size_t head = m_head.load(std::memory_order_acquire);
+			size_t begin = head - m_tail > m_mask + 1 ? head - (m_mask + 1) : m_tail;
+
+			for (size_t ticket = begin; ticket < head; ticket++)
+			{
+				Slot& slot = m_slots[ticket & m_mask];
+
+				if (slot.sequence.load(std::memory_order_acquire) != ticket + 1)
+					continue;
+
+				LogRecord record = slot.record;
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if (slot.sequence.load(std::memory_order_acquire) == ticket + 1)
+					fn(record);
+			}
+
+			m_tail = head;
+		}
+
+		/**
+		* Retrieve the number of records written since the ring was created.
+		*
+		* @return          Number of records written, including overwritten ones.
+		*/
+		size_t written() const
+		{
+			return m_head.load(std::memory_order_relaxed);
+		}
+
+	private:
+		/**
+		* A record along with the ticket it was written with, plus one.
+		*/
+		struct Slot
+		{
+			std::atomic<size_t> sequence{0};
+			LogRecord record;
+		};
+
+		/// Slots of the ring
+		std::unique_ptr<Slot[]> m_slots;
+
+		/// Number of slots minus one, for wrapping tickets
+		size_t m_mask = 0;
+
+		/// Ticket of the next record written
+		std::atomic<size_t> m_head{0};
+
+		/// Ticket of the next record drained
+		size_t m_tail = 0;
+	};
+
+	// =====================================[ Log ]==========================================
+
+	/**
+	* The ring buffer receiving records until another sink is set, unless DIVVY_DEBUG is
+	* defined.
+	*
+	* @return          The default ring buffer.
+	*/
+	inline RingLog& defaultLog()
+	{
+		static RingLog ring;
+		return ring;
+	}
+
+	/**
+	* The sink receiving records until another sink is set: the standard error stream when
+	* DIVVY_DEBUG is defined, so debug output reaches the console, or the default ring
+	* buffer otherwise.
+	*
+	* @return          The default sink.
+	*/
+	inline LogSink& defaultSink()
+	{
+#ifdef DIVVY_DEBUG
+		static StreamSink console(std::cerr);
+		return console;
+#else
+		return defaultLog();
+#endif
+	}
+
+	/**
+	* The sink currently receiving records.
+	*/
+	inline std::atomic<LogSink*>& activeSink()
+	{
+		static std::atomic<LogSink*> sink(&defaultSink());
+		return sink;
+	}
+
+	/**
+	* Set the sink receiving records. The sink has to outlive its use.
+	*
+	* @param sink      The sink to receive records, or nullptr to drop them.
+	*/
+	inline void setLogSink(LogSink* sink)
+	{
+		activeSink().store(sink);
+	}
+
+	/**
+	* Hand a record to the active sink. Use DIVVY_LOG instead, which compiles out.
+	*
+	* @param level     The severity of the record.
+	* @param message   What happened, as a static string.
+	* @param detail    Additional static string.
+	* @param entity    The EntityID involved, or LogRecord::none().
+	*/
+	inline void log(LogLevel level, const char* message, const char* detail, size_t entity)
+	{
+		LogSink* sink = activeSink().load(std::memory_order_acquire);
+
+		if (!sink)
+			return;
+
+		LogRecord record;
+		record.level = level;
+		record.message = message;
+		record.detail = detail;
+		record.entity = entity;
+
+		sink->write(record);
+	}
+
+} // namespace divvy
+
+#endif // DIVVY_LOG_HPP
@@ -0,0 +1,255 @@
+#ifndef DIVVY_PIPELINE_HPP
+#define DIVVY_PIPELINE_HPP
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "ComponentPool.hpp"
+
+namespace divvy {
+
+	/**
+	* The built-in stages of the update pipeline. Stages run in ascending order, so any
+	* other integer can be used as a custom stage, e.g. `Stage::Update + 1`.
+	*/
+	struct Stage
+	{
+		enum : int
+		{
+			PreUpdate  = -100,  ///< Input, scripting, and other preparation
+			Update     = 0,     ///< Simulation, the default for every Component type
+			PostUpdate = 100    ///< Rendering preparation and other follow-ups
+		};
+	};
+
+	/**
+	* How often the stages of the update pipeline run.
+	*/
+	enum class Rate
+	{
+		Fixed,     ///< Once per fixed timestep, possibly several times per frame
+		Variable   ///< Once per frame
+	};
+
+	// ===================================[ Pipeline ]=======================================
+
+	/**
+	* Pipeline decides the order in which Component pools and systems are updated.
+	* Every pool and system is assigned to a stage. Within a stage, they run in the
+	* order in which they were assigned. The resulting order is flattened into a list
+	* that is only rebuilt when assignments change, so an update is a plain loop.
+	*
+	* Systems may assign pools and add systems while the pipeline runs. Such changes take
+	* effect from the next run, except that pools removed meanwhile are skipped at once.
+	*/
+	class Pipeline
+	{
+	public:
+		/// Function run once per update at its stage
+		typedef std::function<void()> System;
+
+		/**
+		* Assign a pool to a stage, or move it to another stage.
+		*
+		* @param pool      The pool to assign.
+		* @param stage     The stage at which the pool is updated.
+		*/
+		void assign(BaseComponentPool& pool, int stage)
+		{
+			for (size_t i = 0; i < m_entries.size(); i++)
+			{
+				if (m_entries[i].pool == &pool)
+				{
+					m_entries[i].stage = stage;
+					m_dirty = true;
+					return;
+				}
+			}
+
+			m_entries.push_back(Entry(stage, m_sequence++, &pool, npos()));
+			m_dirty = true;
+		}
+
+		/**
+		* Remove a pool from the pipeline.
+		*
+		* @param pool      The pool to remove.
+		*/
+		void unassign(BaseComponentPool& pool)
+		{
+			for (size_t i = 0; i < m_entries.size(); i++)
+			{
+				if (m_entries[i].pool == &pool)
+				{
+					m_entries.erase(m_entries.begin() + i);
+					m_dirty = true;
+					break;
+				}
+			}
+
+			if (m_running)
+				for (size_t i = 0; i < m_steps.size(); i++)
+					if (m_steps[i].pool == &pool)
+						m_steps[i].pool = nullptr;     // Skip it for the rest of the run
+		}
+
+		/**
+		* Add a system to a stage.
+		*
+		* @param system    The function to run once per update.
+		* @param stage     The stage at which the system runs.
+		*/
+		void add(System system, int stage)
+		{
+			m_systems.push_back(std::move(system));
+			m_entries.push_back(Entry(stage, m_sequence++, nullptr, m_systems.size() - 1));
+			m_dirty = true;
+		}
+
+		/**
+		* Set how often a stage runs. Stages run at a fixed rate by default.
+		*
+		* @param stage     The stage to set the rate of.
+		* @param rate      How often the stage runs.
+		*/
+		void setRate(int stage, Rate rate)
+		{
+			m_rates[stage] = rate;
+			m_dirty = true;
+		}
+
+		/**
+		* Retrieve how often a stage runs.
+		*
+		* @param stage     The stage to retrieve the rate of.
+		*
+		* @return          How often the stage runs.
+		*/
+		Rate rate(int stage) const
+		{
+			auto it = m_rates.find(stage);
+			return it == m_rates.end() ? Rate::Fixed : it->second;
+		}
+
+		/**
+		* Remove every pool from the pipeline, keeping the systems.
+		*/
+		void clearPools()
+		{
+			m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+				[](const Entry& entry) { return entry.pool != nullptr; }), m_entries.end());
+			m_dirty = true;
+
+			if (m_running)
+				for (size_t i = 0; i < m_steps.size(); i++)
+					m_steps[i].pool = nullptr;
+		}
+
+		/**
+		* Update every pool and run every system, stage by stage.
+		*
+		* @param disabled  Record of the disabled Entities, which pools skip.
+		* @param fixed     Whether the stages of fixed rate run.
+		* @param variable  Whether the stages of variable rate run.
+		*/
+		void run(const std::vector<bool>& disabled, bool fixed = true, bool variable = true)
+		{
+			if (m_running)
+				throw std::runtime_error("Pipeline is already running, cannot run it again");
+
+			if (m_dirty)
+				rebuild();
+
+			m_running = true;
+
+			try
+			{
+				for (size_t i = 0; i < m_steps.size(); i++)
+				{
+					if (!(m_steps[i].fixed ? fixed : variable))
+						continue;
+
+					if (m_steps[i].pool)
+						m_steps[i].pool->update(disabled);
+					else if (m_steps[i].system != npos())
+						m_systems[m_steps[i].system]();
+				}
+			}
+			catch (...)
+			{
+				m_running = false;
+				throw;
+			}
+
+			m_running = false;
+		}
+
+	private:
+		/**
+		* A pool or system assigned to a stage.
+		*/
+		struct Entry
+		{
+			Entry(int stage, size_t sequence, BaseComponentPool* pool, size_t system)
+				: stage(stage), sequence(sequence), pool(pool), system(system) {}
+
+			int stage;
+			size_t sequence;
+			BaseComponentPool* pool;
+			size_t system;
+			bool fixed = true;
+		};
+
+		/**
+		* Flatten the entries into the order in which they run.
+		*/
+		void rebuild()
+		{
+			m_steps = m_entries;
+
+			std::sort(m_steps.begin(), m_steps.end(), [](const Entry& a, const Entry& b)
+			{
+				return a.stage != b.stage ? a.stage < b.stage : a.sequence < b.sequence;
+			});
+
+			for (size_t i = 0; i < m_steps.size(); i++)
+				m_steps[i].fixed = rate(m_steps[i].stage) == Rate::Fixed;
+
+			m_dirty = false;
+		}
+
+		/// Marks an entry without a system
+		static size_t npos()
+		{
+			return static_cast<size_t>(-1);
+		}
+
+		/// Every assigned pool and system
+		std::vector<Entry> m_entries;
+
+		/// Entries in the order in which they run
+		std::vector<Entry> m_steps;
+
+		/// Every system added, never moved so that systems may add more while running
+		std::deque<System> m_systems;
+
+		/// Stages that don't run at the default fixed rate
+		std::map<int, Rate> m_rates;
+
+		/// Order of assignment, breaking ties within a stage
+		size_t m_sequence = 0;
+
+		/// Whether the steps are out of date
+		bool m_dirty = false;
+
+		/// Whether the steps are being run
+		bool m_running = false;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_PIPELINE_HPP
@@ -0,0 +1,149 @@
+#ifndef DIVVY_REFLECTION_HPP
+#define DIVVY_REFLECTION_HPP
+
+#include <typeinfo>
+
+#include "Component.hpp"
+#include "ComponentPool.hpp"
+#include "Entity.hpp"
+
+namespace divvy {
+
+	// =================================[ ComponentType ]====================================
+
+	/**
+	* Type-erased view of a Component type registered in a World, for tooling such as
+	* serializers, inspectors, and diff tools that can't know every type at compile time.
+	* A ComponentType is invalidated when its type is removed from the World.
+	*/
+	class ComponentType
+	{
+	public:
+		/**
+		* Create a view of a pool. Use World::types() or World::type() instead.
+		*
+		* @param pool      The pool holding the Components.
+		* @param world     The World owning the pool.
+		*/
+		ComponentType(BaseComponentPool& pool, const World* world)
+			: m_pool(&pool), m_world(world)
+		{
+		}
+
+		/**
+		* Retrieve the type itself.
+		*
+		* @return          The type.
+		*/
+		const std::type_info& type() const
+		{
+			return *m_pool->info().type;
+		}
+
+		/**
+		* Retrieve the implementation-defined name of the type.
+		*
+		* @return          The name of the type.
+		*/
+		const char* name() const
+		{
+			return m_pool->info().name;
+		}
+
+		/**
+		* Retrieve the size of the type.
+		*
+		* @return          Size in bytes.
+		*/
+		size_t size() const
+		{
+			return m_pool->info().size;
+		}
+
+		/**
+		* Retrieve the alignment of the type.
+		*
+		* @return          Alignment in bytes.
+		*/
+		size_t alignment() const
+		{
+			return m_pool->info().alignment;
+		}
+
+		/**
+		* Check whether the type can be copied as raw bytes. Types deriving from Component
+		* never can, since they hold a vtable and the Entity they are assigned to.
+		*
+		* @return          True if trivially copyable, false otherwise.
+		*/
+		bool trivial() const
+		{
+			return m_pool->info().trivial;
+		}
+
+		/**
+		* Check whether the type is a shared Component.
+		*
+		* @return          True if shared, false otherwise.
+		*/
+		bool shared() const
+		{
+			return m_pool->info().shared;
+		}
+
+		/**
+		* Check whether the type is a tag.
+		*
+		* @return          True if a tag, false otherwise.
+		*/
+		bool tag() const
+		{
+			return m_pool->info().tag;
+		}
+
+		/**
+		* Count the Entities that have a Component of the type.
+		*
+		* @return          Number of Components.
+		*/
+		size_t count() const
+		{
+			return m_pool->count();
+		}
+
+		/**
+		* Check whether an Entity has a Component of the type.
+		*
+		* @param entity    The Entity to check.
+		*
+		* @return          True if the Entity has the Component, false otherwise.
+		*/
+		bool has(const Entity& entity) const
+		{
+			return entity.m_world == m_world && m_pool->has(entity.m_id);
+		}
+
+		/**
+		* Access the object representation of an Entity's Component, size() bytes long.
+		* Tags and shared Components point to the instance shared with other Entities.
+		*
+		* @param entity    The Entity that has the Component.
+		*
+		* @return          Pointer to the Component, or nullptr if the Entity doesn't have one.
+		*/
+		const void* bytes(const Entity& entity) const
+		{
+			return entity.m_world == m_world ? m_pool->bytes(entity.m_id) : nullptr;
+		}
+
+	private:
+		/// The pool holding the Components
+		BaseComponentPool* m_pool;
+
+		/// The World owning the pool
+		const World* m_world;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_REFLECTION_HPP
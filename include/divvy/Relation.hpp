@@ -0,0 +1,152 @@
+#ifndef DIVVY_RELATION_HPP
+#define DIVVY_RELATION_HPP
+
+#include <algorithm>
+#include <vector>
+
+namespace divvy {
+
+	// ================================[ RelationIndex ]=====================================
+
+	/**
+	* RelationIndex stores every pair of a single relation type, such as "targets" or
+	* "owned by". Pairs are indexed in both directions by EntityID, so both the targets
+	* of a source and the sources of a target are found in time proportional to the
+	* amount of results.
+	*/
+	class RelationIndex
+	{
+	public:
+		/**
+		* Relate a source Entity to a target Entity. Relating twice has no effect.
+		*
+		* @param source    The EntityID of the source.
+		* @param target    The EntityID of the target.
+		*/
+		void add(size_t source, size_t target)
+		{
+			reserve(std::max(source, target) + 1);
+
+			if (has(source, target))
+				return;
+
+			m_targets[source].push_back(target);
+			m_sources[target].push_back(source);
+		}
+
+		/**
+		* Check whether a source Entity is related to a target Entity.
+		*
+		* @param source    The EntityID of the source.
+		* @param target    The EntityID of the target.
+		*
+		* @return          True if the pair exists, false otherwise.
+		*/
+		bool has(size_t source, size_t target) const
+		{
+			if (source >= m_targets.size())
+				return false;
+
+			const std::vector<size_t>& targets = m_targets[source];
+			return std::find(targets.begin(), targets.end(), target) != targets.end();
+		}
+
+		/**
+		* Remove the pair of a source Entity and a target Entity.
+		*
+		* @param source    The EntityID of the source.
+		* @param target    The EntityID of the target.
+		*/
+		void remove(size_t source, size_t target)
+		{
+			if (source >= m_targets.size() || target >= m_sources.size())
+				return;
+
+			erase(m_targets[source], target);
+			erase(m_sources[target], source);
+		}
+
+		/**
+		* Remove every pair an Entity takes part in, either as source or as target.
+		*
+		* @param index     The EntityID of the Entity.
+		*/
+		void unlink(size_t index)
+		{
+			if (index >= m_targets.size())
+				return;
+
+			for (size_t i = 0; i < m_targets[index].size(); i++)
+				erase(m_sources[m_targets[index][i]], index);
+
+			for (size_t i = 0; i < m_sources[index].size(); i++)
+				erase(m_targets[m_sources[index][i]], index);
+
+			m_targets[index].clear();
+			m_sources[index].clear();
+		}
+
+		/**
+		* Retrieve the targets of a source Entity.
+		*
+		* @param source    The EntityID of the source.
+		*
+		* @return          EntityIDs of the targets.
+		*/
+		const std::vector<size_t>& targets(size_t source) const
+		{
+			return source < m_targets.size() ? m_targets[source] : m_none;
+		}
+
+		/**
+		* Retrieve the sources relating to a target Entity.
+		*
+		* @param target    The EntityID of the target.
+		*
+		* @return          EntityIDs of the sources.
+		*/
+		const std::vector<size_t>& sources(size_t target) const
+		{
+			return target < m_sources.size() ? m_sources[target] : m_none;
+		}
+
+	private:
+		/**
+		* Grow the indexes to hold the given amount of Entities.
+		*/
+		void reserve(size_t size)
+		{
+			if (m_targets.size() < size)
+			{
+				m_targets.resize(size);
+				m_sources.resize(size);
+			}
+		}
+
+		/**
+		* Remove a value from a list without preserving order.
+		*/
+		static void erase(std::vector<size_t>& list, size_t value)
+		{
+			auto it = std::find(list.begin(), list.end(), value);
+
+			if (it != list.end())
+			{
+				*it = list.back();
+				list.pop_back();
+			}
+		}
+
+		/// Targets of every source Entity
+		std::vector<std::vector<size_t>> m_targets;
+
+		/// Sources of every target Entity
+		std::vector<std::vector<size_t>> m_sources;
+
+		/// Returned for Entities outside of the indexes
+		std::vector<size_t> m_none;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_RELATION_HPP
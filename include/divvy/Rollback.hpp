@@ -0,0 +1,359 @@
+#ifndef DIVVY_ROLLBACK_HPP
+#define DIVVY_ROLLBACK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+#include "ChangeLog.hpp"
+#include "Component.hpp"
+#include "Config.hpp"
+
+namespace divvy {
+
+	// =================================[ StateHistory ]=====================================
+
+	/**
+	* Saved frames of a state that is copied as a whole, for pools whose state is small,
+	* such as tags. The state as of the latest save is kept, along with, for every later
+	* frame, the state it replaced, if it changed at all.
+	*/
+	template <class State>
+	class StateHistory
+	{
+	public:
+		/**
+		* Save a state as a new frame.
+		*
+		* @param current   The state to save.
+		* @param changed   Whether it changed since the previous save.
+		* @param frames    Number of frames kept, including this one.
+		*
+		* @return          1 if the state was copied, 0 otherwise.
+		*/
+		size_t save(const State& current, bool changed, size_t frames)
+		{
+			if (!m_saved)
+			{
+				m_shadow = current;     // Nothing before the first frame to keep
+				m_saved = true;
+				return 1;
+			}
+
+			m_records.push_back(Record());
+
+			if (changed)
+			{
+				m_records.back().changed = true;
+				m_records.back().state = std::move(m_shadow);
+				m_shadow = current;
+			}
+
+			while (m_records.size() + 1 > frames)
+				m_records.pop_front();
+
+			return changed ? 1 : 0;
+		}
+
+		/**
+		* Go back to an earlier save, discarding the saves made after it.
+		*
+		* @param steps     Number of saves to go back, 0 for the latest save.
+		*
+		* @return          The state as of that save.
+		*/
+		const State& restore(size_t steps)
+		{
+			for (size_t i = 0; i < steps && !m_records.empty(); i++)
+			{
+				if (m_records.back().changed)
+					m_shadow = std::move(m_records.back().state);
+
+				m_records.pop_back();
+			}
+
+			return m_shadow;
+		}
+
+		/**
+		* Check whether a state was saved yet.
+		*
+		* @return          True if saved, false otherwise.
+		*/
+		bool saved() const
+		{
+			return m_saved;
+		}
+
+	private:
+		/**
+		* The state replaced by a frame.
+		*/
+		struct Record
+		{
+			bool changed = false;
+			State state;
+		};
+
+		/// The state as of the latest save
+		State m_shadow;
+
+		/// The state replaced by every frame after the oldest, oldest first
+		std::deque<Record> m_records;
+
+		/// Whether a state was saved yet
+		bool m_saved = false;
+	};
+
+	// =================================[ PageHistory ]======================================
+
+	/**
+	* Saved frames of Component storage, split into pages of DIVVY_PAGE_SIZE bytes. A copy
+	* of the storage as of the latest save is kept, and every save only copies the pages
+	* changed since the previous one: the page it replaced goes into the frame's record,
+	* and the current page into the copy. Restoring copies pages back the other way.
+	*
+	* When writes went untracked, such as during an update, every page is compared with
+	* the copy instead, and only the pages that differ count as changed. Components are
+	* compared by their bytes past the Component base, so pages of Components holding
+	* pointers, such as strings, count as changed whenever they are compared.
+	*/
+	template <class T>
+	class PageHistory
+	{
+	public:
+		/**
+		* Save the storage as a new frame.
+		*
+		* @param values    The Components of every slot.
+		* @param active    Which slots hold a Component.
+		* @param changed   The slots changed since the previous save.
+		* @param frames    Number of frames kept, including this one.
+		*
+		* @return          Number of pages copied.
+		*/
+		template <class Values>
+		size_t save(const Values& values, const std::vector<bool>& active, const ChangeLog& changed, size_t frames)
+		{
+			bool first = !m_saved;
+			std::vector<bool> dirty = pages(values, active, changed);
+			size_t copied = 0;
+
+			grow(values.size());
+			m_records.push_back(Record());
+
+			for (size_t page = 0; page < dirty.size(); page++)
+			{
+				if (!dirty[page])
+					continue;
+
+				copied++;
+
+				size_t begin = page * slots(), end = std::min(values.size(), begin + slots());
+
+				if (!first)
+				{
+					m_records.back().push_back(Page());
+					Page& saved = m_records.back().back();
+					saved.index = page;
+					saved.values.assign(m_shadow.begin() + begin, m_shadow.begin() + end);
+					saved.active.assign(m_active.begin() + begin, m_active.begin() + end);
+				}
+
+				copy(values.begin() + begin, values.begin() + end, m_shadow.begin() + begin);
+				std::copy(active.begin() + begin, active.begin() + end, m_active.begin() + begin);
+			}
+
+			if (first)
+				m_records.pop_back();   // Nothing before the first frame to keep
+
+			m_saved = true;
+
+			while (m_records.size() + 1 > frames)
+				m_records.pop_front();
+
+			return copied;
+		}
+
+		/**
+		* Restore the storage as of an earlier save, discarding the saves made after it.
+		*
+		* @param values    The Components of every slot.
+		* @param active    Which slots hold a Component.
+		* @param changed   The slots changed since the latest save.
+		* @param steps     Number of saves to go back, 0 for the latest save.
+		* @param fn        Function taking (size_t begin, size_t end), run on every range
+		*                  of slots restored.
+		*/
+		template <class Values, class Func>
+		void restore(Values& values, std::vector<bool>& active, const ChangeLog& changed, size_t steps, Func fn)
+		{
+			if (!m_saved)
+				return;
+
+			std::vector<bool> dirty = pages(values, active, changed);
+
+			grow(values.size());
+
+			// Undo the changes made since the latest save
+			for (size_t page = 0; page < dirty.size(); page++)
+			{
+				if (!dirty[page])
+					continue;
+
+				size_t begin = page * slots(), end = std::min(values.size(), begin + slots());
+
+				copy(m_shadow.begin() + begin, m_shadow.begin() + end, values.begin() + begin);
+				std::copy(m_active.begin() + begin, m_active.begin() + end, active.begin() + begin);
+				fn(begin, end);
+			}
+
+			// Undo the saves, latest first
+			for (size_t i = 0; i < steps && !m_records.empty(); i++)
+			{
+				Record& record = m_records.back();
+
+				for (size_t j = 0; j < record.size(); j++)
+				{
+					Page& saved = record[j];
+					size_t begin = saved.index * slots(), end = begin + saved.values.size();
+
+					copy(saved.values.begin(), saved.values.end(), m_shadow.begin() + begin);
+					copy(saved.values.begin(), saved.values.end(), values.begin() + begin);
+					std::copy(saved.active.begin(), saved.active.end(), m_active.begin() + begin);
+					std::copy(saved.active.begin(), saved.active.end(), active.begin() + begin);
+					fn(begin, end);
+				}
+
+				m_records.pop_back();
+			}
+		}
+
+		/**
+		* Retrieve the number of slots per page.
+		*
+		* @return          Number of slots.
+		*/
+		static size_t slots()
+		{
+			return sizeof(T) < DIVVY_PAGE_SIZE ? DIVVY_PAGE_SIZE / sizeof(T) : 1;
+		}
+
+	private:
+		/**
+		* A saved page of storage.
+		*/
+		struct Page
+		{
+			size_t index = 0;
+			std::vector<T> values;
+			std::vector<bool> active;
+		};
+
+		/// The pages replaced by a frame
+		typedef std::vector<Page> Record;
+
+		/**
+		* Find the pages holding changed slots. When any slot may have changed, the pages
+		* that differ from the copy are.
+		*/
+		template <class Values>
+		std::vector<bool> pages(const Values& values, const std::vector<bool>& active, const ChangeLog& changed) const
+		{
+			size_t size = values.size();
+			std::vector<bool> dirty((size + slots() - 1) / slots(), changed.all);
+
+			if (changed.all && m_saved)
+			{
+				for (size_t page = 0; page < dirty.size(); page++)
+				{
+					size_t begin = page * slots(), end = std::min(size, begin + slots());
+
+					dirty[page] = end > m_shadow.size() ||
+						!std::equal(active.begin() + begin, active.begin() + end, m_active.begin() + begin) ||
+						!same(values.data() + begin, m_shadow.data() + begin, end - begin);
+				}
+
+				return dirty;
+			}
+
+			for (size_t i = 0; i < changed.slots.size(); i++)
+				if (changed.slots[i] < size)
+					dirty[changed.slots[i] / slots()] = true;
+
+			return dirty;
+		}
+
+		/**
+		* Check whether Components hold the same bytes past the Component base, which
+		* holds the vtable and the Entity.
+		*/
+		static bool same(const T* a, const T* b, size_t count)
+		{
+			const size_t skip = std::is_base_of<Component, T>::value ? sizeof(Component) : 0;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const char* x = reinterpret_cast<const char*>(a + i) + skip;
+				const char* y = reinterpret_cast<const char*>(b + i) + skip;
+
+				if (std::memcmp(x, y, sizeof(T) - skip) != 0)
+					return false;
+			}
+
+			return true;
+		}
+
+		/**
+		* Extend the copy to slots added since, which held no Component before.
+		*/
+		void grow(size_t size)
+		{
+			if (m_shadow.size() < size)
+			{
+				m_shadow.resize(size);
+				m_active.resize(size, false);
+			}
+		}
+
+		/**
+		* Copy Components through their copy assignment, or clone them without one.
+		*/
+		template <class From, class To>
+		static void copy(From begin, From end, To to)
+		{
+			copy(begin, end, to, std::integral_constant<bool, std::is_copy_assignable<T>::value>());
+		}
+
+		template <class From, class To>
+		static void copy(From begin, From end, To to, std::true_type)
+		{
+			std::copy(begin, end, to);
+		}
+
+		template <class From, class To>
+		static void copy(From begin, From end, To to, std::false_type)
+		{
+			for (; begin != end; ++begin, ++to)
+				to->clone(*begin);
+		}
+
+		/// The storage as of the latest save
+		std::vector<T> m_shadow;
+
+		/// Which slots held a Component as of the latest save
+		std::vector<bool> m_active;
+
+		/// The pages replaced by every frame after the oldest, oldest first
+		std::deque<Record> m_records;
+
+		/// Whether the storage was saved yet
+		bool m_saved = false;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_ROLLBACK_HPP
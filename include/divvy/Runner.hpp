@@ -0,0 +1,156 @@
+#ifndef DIVVY_RUNNER_HPP
+#define DIVVY_RUNNER_HPP
+
+#include <cmath>
+#include <stdexcept>
+
+#include "Pipeline.hpp"
+#include "World.hpp"
+
+namespace divvy {
+
+	// =====================================[ Clock ]========================================
+
+	/**
+	* Singleton describing the time of the update being run, kept up to date by a Runner.
+	*/
+	struct Clock
+	{
+		/// Seconds covered by the current update
+		double delta = 0;
+
+		/// Progress between the previous and the current fixed step, in [0, 1)
+		double alpha = 0;
+
+		/// Seconds simulated through fixed steps so far
+		double time = 0;
+	};
+
+	// =====================================[ Runner ]=======================================
+
+	/**
+	* Runner drives a World with time. Elapsed time is accumulated and consumed in fixed
+	* steps by the stages of fixed rate, while the stages of variable rate run once per
+	* frame. This decouples the simulation rate from the rendering rate.
+	*
+	* Every frame is a single World frame: events are swapped and statistics start a new
+	* tick once per frame, not once per step. Previous values of interpolated types are
+	* only saved before the last fixed step of a frame, since rendering only blends that one.
+	*/
+	class Runner
+	{
+	public:
+		/**
+		* Create a Runner for a World.
+		*
+		* @param world     The World to drive.
+		* @param step      Seconds covered by a fixed step.
+		* @param maxSteps  Most fixed steps run per frame. Time beyond that is dropped, so a
+		*                  slow frame can't cause ever slower frames.
+		*/
+		Runner(World& world, double step, size_t maxSteps = 5)
+			: m_world(world), m_step(step), m_maxSteps(maxSteps)
+		{
+			if (!(step > 0))
+				throw std::runtime_error("Runner step has to be positive");
+
+			if (maxSteps == 0)
+				throw std::runtime_error("Runner has to allow at least one step per frame");
+		}
+
+		/**
+		* Advance the World by the time elapsed since the last frame.
+		*
+		* @param elapsed   Seconds elapsed since the last frame.
+		*
+		* @return          Number of fixed steps run.
+		*/
+		size_t advance(double elapsed)
+		{
+			size_t steps = 0;
+			double remaining = m_accumulator + elapsed;
+
+			// Count the steps first, so the last one is known
+			while (remaining >= m_step && steps < m_maxSteps)
+			{
+				remaining -= m_step;
+				steps++;
+			}
+
+			m_accumulator += elapsed;
+			m_world.beginFrame();
+
+			try
+			{
+				for (size_t i = 0; i < steps; i++)
+				{
+					m_accumulator -= m_step;
+
+					Clock& clock = m_world.singleton<Clock>();  // Systems may replace it
+					clock.delta = m_step;
+					clock.time += m_step;
+
+					if (i + 1 == steps)
+						m_world.savePrevious();
+
+					m_world.update(Rate::Fixed);
+				}
+
+				// Catching up took too long, drop the remaining whole steps
+				if (m_accumulator >= m_step)
+					m_accumulator = std::fmod(m_accumulator, m_step);
+
+				Clock& clock = m_world.singleton<Clock>();
+				clock.delta = elapsed;
+				clock.alpha = alpha();
+				m_world.update(Rate::Variable);
+			}
+			catch (...)
+			{
+				m_world.endFrame();
+				throw;
+			}
+
+			m_world.endFrame();
+
+			return steps;
+		}
+
+		/**
+		* Retrieve the progress between the previous and the current fixed step, for
+		* interpolating Component values.
+		*
+		* @return          Progress in [0, 1).
+		*/
+		double alpha() const
+		{
+			return m_accumulator / m_step;
+		}
+
+		/**
+		* Retrieve the seconds covered by a fixed step.
+		*
+		* @return          Seconds per fixed step.
+		*/
+		double step() const
+		{
+			return m_step;
+		}
+
+	private:
+		/// The World being driven
+		World& m_world;
+
+		/// Seconds covered by a fixed step
+		double m_step;
+
+		/// Most fixed steps run per frame
+		size_t m_maxSteps;
+
+		/// Elapsed time not yet consumed by fixed steps
+		double m_accumulator = 0;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_RUNNER_HPP
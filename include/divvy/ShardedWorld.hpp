@@ -0,0 +1,475 @@
+#ifndef DIVVY_SHARDEDWORLD_HPP
+#define DIVVY_SHARDEDWORLD_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "World.hpp"
+
+/*
+* ShardedWorld runs shards on threads, so it is not included by divvy.hpp.
+* Include "divvy/ShardedWorld.hpp" and link against the platform's thread library.
+*/
+
+namespace divvy {
+
+	// ==================================[ ShardHandle ]=====================================
+
+	/**
+	* Identifies an Entity of a ShardedWorld by value, such as to send it to another
+	* machine. A handle goes stale once its Entity is removed or migrates to another shard.
+	*/
+	struct ShardHandle
+	{
+		/// The shard the Entity exists in
+		size_t shard = 0;
+
+		/// The EntityID within the shard
+		EntityID id = 0;
+
+		/// The generation of the Entity's slot
+		size_t generation = 0;
+	};
+
+	// ==================================[ ShardedWorld ]====================================
+
+	/**
+	* Partitions Entities into several Worlds, the shards, by a user key such as a map
+	* region. Shards share no state, so they are updated in parallel, one thread each.
+	* The threads are started by the first update and wait for the next one in between.
+	* Entities crossing from one shard to another are queued, and migrated at the sync
+	* point that follows every update, while no shard is running.
+	*
+	* Entity objects stay valid through migrations, so a reference or pointer to an Entity
+	* works as a handle across shards. Queued Entities that are removed before the next
+	* sync point are skipped. Systems must not touch the Entities of other shards during
+	* an update.
+	*/
+	template <class Key = size_t>
+	class ShardedWorld
+	{
+	public:
+		/// Function mapping a key to the index of a shard
+		typedef std::function<size_t(const Key&)> Partition;
+
+		/**
+		* Create the shards.
+		*
+		* @param count     Number of shards.
+		* @param partition Function mapping a key to a shard, hashing the key by default.
+		*/
+		ShardedWorld(size_t count, Partition partition = Partition())
+			: m_partition(partition)
+		{
+			if (count == 0)
+				throw std::runtime_error("ShardedWorld needs at least one shard");
+
+			if (!m_partition)
+				m_partition = [count](const Key& key) { return std::hash<Key>()(key) % count; };
+
+			for (size_t i = 0; i < count; i++)
+				m_shards.push_back(make_unique<World>());
+		}
+
+		/**
+		* Stop the worker threads.
+		*/
+		~ShardedWorld()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_workMutex);
+				m_stopping = true;
+			}
+
+			m_wake.notify_all();
+
+			for (size_t i = 0; i < m_workers.size(); i++)
+				m_workers[i].join();
+		}
+
+		/**
+		* Register a Component type in every shard.
+		*
+		* @param stage     The stage of the update at which the Components are updated.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		void add(int stage = Stage::Update)
+		{
+			for (size_t i = 0; i < m_shards.size(); i++)
+				m_shards[i]->add<T>(stage);
+		}
+
+		/**
+		* Run a function at a stage of every shard's update. The function is run once per
+		* shard, concurrently with the other shards.
+		*
+		* @param fn        Function taking (World& shard).
+		* @param stage     The stage at which the function runs.
+		*/
+		void system(std::function<void(World&)> fn, int stage = Stage::Update)
+		{
+			for (size_t i = 0; i < m_shards.size(); i++)
+				m_shards[i]->system(fn, stage);
+		}
+
+		/**
+		* Retrieve the number of shards.
+		*
+		* @return          Number of shards.
+		*/
+		size_t size() const
+		{
+			return m_shards.size();
+		}
+
+		/**
+		* Retrieve a shard.
+		*
+		* @param index     The index of the shard.
+		*
+		* @return          Reference to the shard.
+		*/
+		World& shard(size_t index)
+		{
+			return *divvy::at(m_shards, index);
+		}
+
+		/**
+		* Retrieve the index of the shard a key belongs to.
+		*
+		* @param key       The key to partition.
+		*
+		* @return          The index of the shard.
+		*/
+		size_t shardOf(const Key& key) const
+		{
+			size_t index = m_partition(key);
+
+			if (index >= m_shards.size())
+				throw std::runtime_error("Partition mapped a key past the last shard");
+
+			return index;
+		}
+
+		/**
+		* Retrieve the shard a key belongs to, such as to create an Entity in it.
+		*
+		* @param key       The key to partition.
+		*
+		* @return          Reference to the shard.
+		*/
+		World& operator[](const Key& key)
+		{
+			return *m_shards[shardOf(key)];
+		}
+
+		/**
+		* Retrieve the index of the shard an Entity exists in.
+		*
+		* @param entity    The Entity to locate.
+		*
+		* @return          The index of the shard, or npos() if it is in none.
+		*/
+		size_t locate(const Entity& entity) const
+		{
+			for (size_t i = 0; i < m_shards.size(); i++)
+				if (m_shards[i].get() == entity.world())
+					return i;
+
+			return npos();
+		}
+
+		/**
+		* Marks the absence of a shard.
+		*/
+		static size_t npos()
+		{
+			return static_cast<size_t>(-1);
+		}
+
+		/**
+		* Queue an Entity to migrate to the shard of a key at the next sync point. Safe to
+		* call from systems while the shards are updating. When an Entity is queued more
+		* than once, the last key wins. Entities in no shard are ignored.
+		*
+		* @param entity    The Entity to migrate.
+		* @param key       The key the Entity now belongs to.
+		*/
+		void migrate(Entity& entity, const Key& key)
+		{
+			size_t target = shardOf(key);
+
+			if (locate(entity) == npos())
+				return;
+
+			Move move{handle(entity), target};
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_moves.push_back(move);
+		}
+
+		/**
+		* Create a handle identifying an Entity by value.
+		*
+		* @param entity    The Entity, existing in one of the shards.
+		*
+		* @return          The handle.
+		*/
+		ShardHandle handle(const Entity& entity)
+		{
+			ShardHandle handle;
+			handle.shard = locate(entity);
+
+			if (handle.shard == npos())
+				throw std::runtime_error("Entity does not exist in any shard");
+
+			handle.id = entity.id();
+			handle.generation = m_shards[handle.shard]->generation(entity);
+
+			return handle;
+		}
+
+		/**
+		* Resolve a handle to its Entity.
+		*
+		* @param handle    The handle created through handle().
+		*
+		* @return          Pointer to the Entity, or nullptr if the handle went stale.
+		*/
+		Entity* resolve(const ShardHandle& handle)
+		{
+			if (handle.shard >= m_shards.size())
+				return nullptr;
+
+			return m_shards[handle.shard]->lookup(handle.id, handle.generation);
+		}
+
+		/**
+		* Update every shard in parallel, then sync.
+		*/
+		void update()
+		{
+			parallel([](World& shard) { shard.update(); });
+			sync();
+		}
+
+		/**
+		* Update the stages of a rate in every shard in parallel, then sync.
+		*
+		* @param rate      The rate whose stages are run.
+		*/
+		void update(Rate rate)
+		{
+			parallel([rate](World& shard) { shard.update(rate); });
+			sync();
+		}
+
+		/**
+		* Run a function on every shard, each on its own worker thread. Exceptions are
+		* rethrown once every shard is done. Not reentrant.
+		*
+		* @param fn        Function taking (World& shard).
+		*/
+		void parallel(std::function<void(World&)> fn)
+		{
+			if (m_workers.size() + 1 < m_shards.size())
+				start();
+
+			m_errors.assign(m_shards.size(), std::exception_ptr());
+			{
+				std::lock_guard<std::mutex> lock(m_workMutex);
+				m_task = &fn;
+				m_busy = m_workers.size();
+				m_round++;
+			}
+
+			m_wake.notify_all();
+
+			// The calling thread takes the first shard
+			run(fn, 0, m_errors[0]);
+			{
+				std::unique_lock<std::mutex> lock(m_workMutex);
+				m_done.wait(lock, [this]() { return m_busy == 0; });
+			}
+
+			for (size_t i = 0; i < m_errors.size(); i++)
+				if (m_errors[i])
+					std::rethrow_exception(m_errors[i]);
+		}
+
+		/**
+		* Migrate the queued Entities. Entities moving between the same pair of shards are
+		* migrated as one batch. Entities removed since they were queued are skipped.
+		*/
+		void sync()
+		{
+			std::vector<Move> moves;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				moves.swap(m_moves);
+			}
+
+			// Keep the last move of every Entity
+			std::stable_sort(moves.begin(), moves.end(), [](const Move& a, const Move& b)
+			{
+				return a.handle.shard != b.handle.shard ? a.handle.shard < b.handle.shard : a.handle.id < b.handle.id;
+			});
+
+			std::vector<Batch> batches;
+
+			for (size_t i = 0; i < moves.size(); i++)
+			{
+				const ShardHandle& handle = moves[i].handle;
+
+				if (i + 1 < moves.size() && moves[i + 1].handle.shard == handle.shard && moves[i + 1].handle.id == handle.id)
+					continue;
+
+				Entity* entity = resolve(handle);
+
+				if (entity != nullptr && handle.shard != moves[i].target)
+					batches.push_back(Batch{handle.shard, moves[i].target, entity});
+			}
+
+			std::stable_sort(batches.begin(), batches.end(), [](const Batch& a, const Batch& b)
+			{
+				return a.source != b.source ? a.source < b.source : a.target < b.target;
+			});
+
+			std::vector<Entity*> batch;
+
+			for (size_t i = 0; i < batches.size(); i++)
+			{
+				batch.push_back(batches[i].entity);
+
+				if (i + 1 == batches.size() || batches[i + 1].source != batches[i].source ||
+					batches[i + 1].target != batches[i].target)
+				{
+					m_shards[batches[i].source]->migrate(batch.begin(), batch.end(), *m_shards[batches[i].target]);
+					batch.clear();
+				}
+			}
+		}
+
+	private:
+		/**
+		* A queued migration.
+		*/
+		struct Move
+		{
+			ShardHandle handle;
+			size_t target;
+		};
+
+		/**
+		* A queued migration along with the shard it leaves.
+		*/
+		struct Batch
+		{
+			size_t source;
+			size_t target;
+			Entity* entity;
+		};
+
+		/**
+		* Run a function on a shard, capturing what it throws.
+		*/
+		void run(const std::function<void(World&)>& fn, size_t index, std::exception_ptr& error)
+		{
+			try
+			{
+				fn(*m_shards[index]);
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+		}
+
+		/**
+		* Start a worker thread for every shard but the first.
+		*/
+		void start()
+		{
+			for (size_t i = m_workers.size() + 1; i < m_shards.size(); i++)
+				m_workers.push_back(std::thread(&ShardedWorld::work, this, i, m_round));
+		}
+
+		/**
+		* Run the function of every round on a shard until the workers are stopped.
+		*
+		* @param index     The index of the shard.
+		* @param round     The last round already run.
+		*/
+		void work(size_t index, size_t round)
+		{
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_workMutex);
+					m_wake.wait(lock, [&]() { return m_stopping || m_round != round; });
+
+					if (m_stopping)
+						return;
+
+					round = m_round;
+				}
+
+				run(*m_task, index, m_errors[index]);
+
+				std::lock_guard<std::mutex> lock(m_workMutex);
+
+				if (--m_busy == 0)
+					m_done.notify_one();
+			}
+		}
+
+		/// The shards, each a World of its own
+		std::vector<std::unique_ptr<World>> m_shards;
+
+		/// Function mapping a key to a shard
+		Partition m_partition;
+
+		/// Migrations waiting for the next sync point
+		std::vector<Move> m_moves;
+
+		/// Guards the queued migrations
+		std::mutex m_mutex;
+
+		/// Worker threads updating every shard but the first
+		std::vector<std::thread> m_workers;
+
+		/// The function run by the current round
+		const std::function<void(World&)>* m_task = nullptr;
+
+		/// What each shard threw during the current round
+		std::vector<std::exception_ptr> m_errors;
+
+		/// Rounds started, where workers run a function each round
+		size_t m_round = 0;
+
+		/// Workers still running the current round
+		size_t m_busy = 0;
+
+		/// Whether the workers have to stop
+		bool m_stopping = false;
+
+		/// Guards the rounds
+		std::mutex m_workMutex;
+
+		/// Signals the workers that a round started or that they have to stop
+		std::condition_variable m_wake;
+
+		/// Signals the caller that every worker finished the round
+		std::condition_variable m_done;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_SHARDEDWORLD_HPP
@@ -0,0 +1,58 @@
+#ifndef DIVVY_SINGLETON_HPP
+#define DIVVY_SINGLETON_HPP
+
+#include <utility>
+
+namespace divvy {
+
+	// =================================[ BaseSingleton ]====================================
+
+	/**
+	* Base polymorphic singleton container.
+	* Used for storing different types of world-global state in a single container.
+	*/
+	class BaseSingleton
+	{
+	public:
+		/**
+		* Allow derived singletons to have a destructor.
+		*/
+		virtual ~BaseSingleton() {}
+	};
+
+	// ===================================[ Singleton ]======================================
+
+	/**
+	* Derived polymorphic singleton container.
+	* Holds the single instance of world-global state, such as a game clock or input.
+	*/
+	template <class T>
+	class Singleton : public BaseSingleton
+	{
+	public:
+		/**
+		* Create the singleton instance.
+		*
+		* @param args      Arguments to feed to the instance's constructor.
+		*/
+		template <class ... Args>
+		Singleton(Args&& ... args) : m_value(std::forward<Args>(args)...) {}
+
+		/**
+		* Access the singleton instance.
+		*
+		* @return          Reference to the instance.
+		*/
+		T& get()
+		{
+			return m_value;
+		}
+
+	private:
+		/// The single instance
+		T m_value;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_SINGLETON_HPP
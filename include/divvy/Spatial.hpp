@@ -0,0 +1,350 @@
+#ifndef DIVVY_SPATIAL_HPP
+#define DIVVY_SPATIAL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "ComponentPool.hpp"
+
+namespace divvy {
+
+	// =====================================[ Point ]========================================
+
+	/**
+	* A position in two-dimensional space, as used by spatial indexes.
+	*/
+	struct Point
+	{
+		Point() {}
+
+		Point(float x, float y) : x(x), y(y) {}
+
+		float x = 0, y = 0;
+	};
+
+	// ===============================[ BaseSpatialIndex ]===================================
+
+	/**
+	* Base polymorphic spatial index.
+	* A spatial index follows the changes of a position Component and answers proximity
+	* queries with the EntityIDs that match. Derive from this class to provide a different
+	* partitioning scheme, such as a quadtree.
+	*/
+	class BaseSpatialIndex : public ChangeListener
+	{
+	public:
+		/**
+		* Collect every Entity within a radius of a point.
+		*
+		* @param center    The center of the circle.
+		* @param radius    The radius of the circle.
+		* @param found     The EntityIDs found are appended to this.
+		*/
+		virtual void queryRadius(Point center, float radius, std::vector<size_t>& found) = 0;
+
+		/**
+		* Collect every Entity within an axis-aligned bounding box.
+		*
+		* @param low       The corner of the box with the lowest coordinates.
+		* @param high      The corner of the box with the highest coordinates.
+		* @param found     The EntityIDs found are appended to this.
+		*/
+		virtual void queryAABB(Point low, Point high, std::vector<size_t>& found) = 0;
+	};
+
+	// ==================================[ SpatialGrid ]=====================================
+
+	/**
+	* Spatial index partitioning space into a uniform grid of square cells.
+	* Only Entities whose position Component changed since the last query are moved
+	* between cells, so the grid never has to be rebuilt as a whole.
+	*
+	* Changes made through Entity::add(), Entity::get(), Entity::mutate(), Accessors, and
+	* removal are tracked per Entity, while Entity::read() counts as no change. Spans and
+	* the updates of position types that have any make the next query extract every
+	* position again, so keep the position Component data only and move it from systems.
+	*/
+	template <class T>
+	class SpatialGrid : public BaseSpatialIndex
+	{
+	public:
+		typedef T component_type;
+
+		/// Function extracting the position from a Component
+		typedef std::function<Point(const T&)> Extractor;
+
+		/**
+		* Create a grid over every Component of a pool.
+		*
+		* @param pool      The pool holding the position Components.
+		* @param cellSize  The width and height of a cell. Ideally close to the typical query radius.
+		* @param extract   Function extracting the position from a Component.
+		*/
+		SpatialGrid(pool_type<T>& pool, float cellSize, Extractor extract)
+			: m_pool(pool), m_cellSize(cellSize), m_extract(extract)
+		{
+			if (!(cellSize > 0))
+				throw std::runtime_error("SpatialGrid cell size has to be positive");
+
+			for (size_t i = 0; i < pool.capacity(); i++)
+				if (pool.has(i))
+					changed(i);
+		}
+
+		virtual void changed(size_t index)
+		{
+			if (index >= m_pending.size())
+				m_pending.resize(index + 1, false);
+
+			if (!m_pending[index])
+			{
+				m_pending[index] = true;
+				m_dirty.push_back(index);
+			}
+		}
+
+		virtual void changedAll()
+		{
+			m_stale = true;
+		}
+
+		virtual void queryRadius(Point center, float radius, std::vector<size_t>& found)
+		{
+			float squared = radius * radius;
+
+			query(Point(center.x - radius, center.y - radius), Point(center.x + radius, center.y + radius),
+				[&](size_t index)
+			{
+				float dx = m_points[index].x - center.x;
+				float dy = m_points[index].y - center.y;
+
+				if (dx * dx + dy * dy <= squared)
+					found.push_back(index);
+			});
+		}
+
+		virtual void queryAABB(Point low, Point high, std::vector<size_t>& found)
+		{
+			query(low, high, [&](size_t index)
+			{
+				const Point& point = m_points[index];
+
+				if (point.x >= low.x && point.x <= high.x && point.y >= low.y && point.y <= high.y)
+					found.push_back(index);
+			});
+		}
+
+	private:
+		/**
+		* Run a function on every Entity in the cells overlapping a box. The box is first
+		* clipped to the occupied cells, and when it still spans more cells than are
+		* occupied, the occupied cells are visited instead.
+		*/
+		template <class Func>
+		void query(Point low, Point high, Func fn)
+		{
+			refresh();
+
+			if (!(low.x <= high.x && low.y <= high.y) || m_cells.empty())
+				return;     // Empty or not a number
+
+			int64_t lowX = std::max(coordinate(low.x), m_lowX), highX = std::min(coordinate(high.x), m_highX);
+			int64_t lowY = std::max(coordinate(low.y), m_lowY), highY = std::min(coordinate(high.y), m_highY);
+
+			if (lowX > highX || lowY > highY)
+				return;
+
+			if (static_cast<double>(highX - lowX + 1) * static_cast<double>(highY - lowY + 1) > m_cells.size())
+			{
+				for (auto it = m_cells.begin(); it != m_cells.end(); it++)
+				{
+					int64_t x = static_cast<int32_t>(it->first >> 32), y = static_cast<int32_t>(it->first);
+
+					if (x >= lowX && x <= highX && y >= lowY && y <= highY)
+						for (size_t i = 0; i < it->second.size(); i++)
+							fn(it->second[i]);
+				}
+
+				return;
+			}
+
+			for (int64_t x = lowX; x <= highX; x++)
+			{
+				for (int64_t y = lowY; y <= highY; y++)
+				{
+					auto it = m_cells.find(key(x, y));
+
+					if (it != m_cells.end())
+						for (size_t i = 0; i < it->second.size(); i++)
+							fn(it->second[i]);
+				}
+			}
+		}
+
+		/**
+		* Move every Entity that changed since the last query into its current cell.
+		*/
+		void refresh()
+		{
+			if (m_stale)
+			{
+				m_stale = false;
+
+				for (size_t i = 0; i < m_pool.capacity(); i++)
+					changed(i);
+			}
+
+			for (size_t i = 0; i < m_dirty.size(); i++)
+			{
+				size_t index = m_dirty[i];
+				m_pending[index] = false;
+
+				if (!m_pool.has(index))
+				{
+					erase(index);
+					continue;
+				}
+
+				Point point = m_extract(static_cast<const pool_type<T>&>(m_pool).get(index));
+				uint64_t cell = key(coordinate(point.x), coordinate(point.y));
+
+				if (index >= m_points.size())
+				{
+					m_points.resize(index + 1);
+					m_cell.resize(index + 1);
+					m_position.resize(index + 1, npos());
+				}
+
+				m_points[index] = point;
+
+				if (m_position[index] != npos() && m_cell[index] == cell)
+					continue;   // Still within the same cell
+
+				erase(index);
+				insert(index, cell);
+			}
+
+			m_dirty.clear();
+		}
+
+		/**
+		* Add an Entity to a cell.
+		*/
+		void insert(size_t index, uint64_t cell)
+		{
+			int64_t x = static_cast<int32_t>(cell >> 32), y = static_cast<int32_t>(cell);
+
+			if (m_cells.empty())
+			{
+				m_lowX = m_highX = x;
+				m_lowY = m_highY = y;
+			}
+			else
+			{
+				m_lowX = std::min(m_lowX, x);
+				m_highX = std::max(m_highX, x);
+				m_lowY = std::min(m_lowY, y);
+				m_highY = std::max(m_highY, y);
+			}
+
+			std::vector<size_t>& entities = m_cells[cell];
+
+			m_cell[index] = cell;
+			m_position[index] = entities.size();
+			entities.push_back(index);
+		}
+
+		/**
+		* Remove an Entity from its cell, if it is in one.
+		*/
+		void erase(size_t index)
+		{
+			if (index >= m_position.size() || m_position[index] == npos())
+				return;
+
+			auto it = m_cells.find(m_cell[index]);
+			std::vector<size_t>& entities = it->second;
+
+			// Swap the last Entity into the released position
+			size_t last = entities.back();
+			entities[m_position[index]] = last;
+			m_position[last] = m_position[index];
+			entities.pop_back();
+
+			if (entities.empty())
+				m_cells.erase(it);
+
+			m_position[index] = npos();
+		}
+
+		/**
+		* Convert a coordinate to the coordinate of its cell, saturated to the cells that
+		* fit a key. Positions that are not a number all go to the cell at the origin,
+		* where no query matches them.
+		*/
+		int64_t coordinate(float value) const
+		{
+			double cell = std::floor(static_cast<double>(value) / m_cellSize);
+
+			if (cell != cell)
+				return 0;
+
+			return static_cast<int64_t>(std::max(-2147483648.0, std::min(2147483647.0, cell)));
+		}
+
+		/**
+		* Combine the coordinates of a cell into a single key.
+		*/
+		static uint64_t key(int64_t x, int64_t y)
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+		}
+
+		/// Marks an Entity that isn't in a cell
+		static size_t npos()
+		{
+			return static_cast<size_t>(-1);
+		}
+
+		/// The pool holding the position Components
+		pool_type<T>& m_pool;
+
+		/// The width and height of a cell
+		float m_cellSize;
+
+		/// Function extracting the position from a Component
+		Extractor m_extract;
+
+		/// Entities within every occupied cell
+		std::unordered_map<uint64_t, std::vector<size_t>> m_cells;
+
+		/// Bounds of the cells occupied since the grid was last empty
+		int64_t m_lowX = 0, m_highX = 0, m_lowY = 0, m_highY = 0;
+
+		/// Last known position of every Entity
+		std::vector<Point> m_points;
+
+		/// Cell of every Entity
+		std::vector<uint64_t> m_cell;
+
+		/// Position of every Entity within its cell
+		std::vector<size_t> m_position;
+
+		/// Entities that changed since the last query
+		std::vector<size_t> m_dirty;
+
+		/// Whether an Entity is already queued in m_dirty
+		std::vector<bool> m_pending;
+
+		/// Whether any Entity may have changed without being queued
+		bool m_stale = false;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_SPATIAL_HPP
@@ -0,0 +1,213 @@
+#ifndef DIVVY_STATS_HPP
+#define DIVVY_STATS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace divvy {
+
+	// ================================[ ComponentStats ]====================================
+
+	/**
+	* Churn of a single Component type during a tick.
+	*/
+	struct ComponentStats
+	{
+		/// Components added, including those cloned or recycled
+		size_t added = 0;
+
+		/// Components removed, including those of removed Entities
+		size_t removed = 0;
+
+		/// Pages of storage copied by saves, or states for tags and shared Components
+		size_t saved = 0;
+	};
+
+	/**
+	* Counts the churn of a Component type. Counts roll over lazily when the tick
+	* changes, so idle Component types cost nothing per tick.
+	*/
+	class ChurnCounter
+	{
+	public:
+		/**
+		* Count an added Component.
+		*
+		* @param tick      The current tick.
+		*/
+		inline void added(size_t tick)
+		{
+			roll(tick);
+			m_current.added++;
+		}
+
+		/**
+		* Count a removed Component.
+		*
+		* @param tick      The current tick.
+		*/
+		inline void removed(size_t tick)
+		{
+			roll(tick);
+			m_current.removed++;
+		}
+
+		/**
+		* Count the pages copied by a save.
+		*
+		* @param tick      The current tick.
+		* @param pages     Number of pages copied.
+		*/
+		inline void saved(size_t tick, size_t pages)
+		{
+			roll(tick);
+			m_current.saved += pages;
+		}
+
+		/**
+		* Retrieve the churn of the tick before the current one.
+		*
+		* @param tick      The current tick.
+		*
+		* @return          The churn of the previous tick.
+		*/
+		ComponentStats last(size_t tick)
+		{
+			roll(tick);
+			return m_last;
+		}
+
+	private:
+		/**
+		* Start counting a new tick, if the tick changed.
+		*/
+		inline void roll(size_t tick)
+		{
+			if (tick == m_tick)
+				return;
+
+			m_last = tick == m_tick + 1 ? m_current : ComponentStats();
+			m_current = ComponentStats();
+			m_tick = tick;
+		}
+
+		/// The tick being counted
+		size_t m_tick = 0;
+
+		/// Churn of the tick being counted
+		ComponentStats m_current;
+
+		/// Churn of the tick before
+		ComponentStats m_last;
+	};
+
+	// ===================================[ TickStats ]======================================
+
+	/**
+	* Lifecycle statistics of a World during a tick, which runs from the start of one
+	* update to the start of the next.
+	*/
+	struct TickStats
+	{
+		/// Number of the tick, starting at zero
+		size_t tick = 0;
+
+		/// Entities created
+		size_t created = 0;
+
+		/// Entities created in the slot of a removed Entity
+		size_t reused = 0;
+
+		/// Entities removed
+		size_t destroyed = 0;
+
+		/// Times a Component pool had to reallocate to fit more Entities
+		size_t resizes = 0;
+
+		/// Entities existing at the end of the tick
+		size_t entities = 0;
+
+		/**
+		* Retrieve the share of created Entities that reused a slot.
+		*
+		* @return          Share between 0 and 1, or 0 without created Entities.
+		*/
+		double reuseRate() const
+		{
+			return created ? static_cast<double>(reused) / created : 0;
+		}
+	};
+
+	// =================================[ StatsHistory ]=====================================
+
+	/**
+	* Ring buffer keeping the statistics of the latest ticks.
+	*/
+	class StatsHistory
+	{
+	public:
+		/**
+		* Create a history.
+		*
+		* @param capacity  Number of ticks kept.
+		*/
+		StatsHistory(size_t capacity)
+			: m_ticks(capacity)
+		{
+		}
+
+		/**
+		* Keep the statistics of a tick, overwriting the oldest once full.
+		*
+		* @param stats     The statistics of the tick.
+		*/
+		void push(const TickStats& stats)
+		{
+			if (m_ticks.empty())
+				return;
+
+			m_ticks[m_next] = stats;
+			m_next = (m_next + 1) % m_ticks.size();
+
+			if (m_size < m_ticks.size())
+				m_size++;
+		}
+
+		/**
+		* Run a function on the statistics of every tick kept, oldest first.
+		*
+		* @param fn        Function taking (const TickStats& stats).
+		*/
+		template <class Func>
+		void each(Func fn) const
+		{
+			size_t first = (m_next + m_ticks.size() - m_size) % m_ticks.size();
+
+			for (size_t i = 0; i < m_size; i++)
+				fn(m_ticks[(first + i) % m_ticks.size()]);
+		}
+
+		/**
+		* Retrieve the number of ticks kept.
+		*
+		* @return          Number of ticks.
+		*/
+		size_t size() const
+		{
+			return m_size;
+		}
+
+	private:
+		/// Statistics of the ticks kept
+		std::vector<TickStats> m_ticks;
+
+		/// Position the next tick is written to
+		size_t m_next = 0;
+
+		/// Number of ticks kept
+		size_t m_size = 0;
+	};
+
+} // namespace divvy
+
+#endif // DIVVY_STATS_HPP
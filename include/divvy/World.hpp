@@ -1,14 +1,29 @@
 #ifndef DIVVY_WORLD_HPP
 #define DIVVY_WORLD_HPP
 
+#include <algorithm>
 #include <map>
 #include <memory>
-#include <set>
 #include <typeindex>
 
+#include "Accessor.hpp"
 #include "Component.hpp"
 #include "ComponentPool.hpp"
+#include "Config.hpp"
 #include "Entity.hpp"
+#include "EntityTable.hpp"
+#include "Event.hpp"
+#include "Hash.hpp"
+#include "Hierarchy.hpp"
+#include "History.hpp"
+#include "Index.hpp"
+#include "Log.hpp"
+#include "Pipeline.hpp"
+#include "Reflection.hpp"
+#include "Relation.hpp"
+#include "Singleton.hpp"
+#include "Spatial.hpp"
+#include "Stats.hpp"
 
 namespace divvy{
 
@@ -44,25 +59,38 @@ namespace divvy{
 		~World()
 		{
 			// Uninitialize every Entity in this World
-			for (Entity& entity : m_entities)
+			m_entities.each([](Entity& entity)
 			{
 				entity.m_id = 0;
 				entity.m_world = nullptr;
-			}
+			});
 		}
 
 		/**
-		* Register a Component type to this World.
+		* Register a Component type to this World. Registering a type again has no
+		* effect, use setStage() to move it to another stage.
+		*
+		* @param stage     The stage of the update at which the Components are updated.
 		*/
 		template <class T, typename = is_valid_component<T>>
-		void add()
+		void add(int stage = Stage::Update)
 		{
-			m_registry.insert(std::make_pair(std::type_index(typeid(T)), make_unique<ComponentPool<T>>()));
-			m_registry.at(typeid(T))->resize(m_capacity);
+			auto result = m_registry.insert(std::make_pair(std::type_index(typeid(T)), make_unique<pool_type<T>>()));
+			result.first->second->resize(m_entities.size());
+
+			if (result.second)
+			{
+				m_pipeline.assign(*result.first->second, stage);
+
+				size_t id = typeID<T>();
+
+				if (id >= m_pools.size())
+					m_pools.resize(id + 1, nullptr);
+
+				m_pools[id] = result.first->second.get();
+			}
 
-#ifdef DIVVY_DEBUG
-			std::cout << "-- Registered Component Type: " << typeid(T).name() << std::endl;
-#endif
+			DIVVY_LOG(Info, "Registered Component type", typeid(T).name(), LogRecord::none());
 		}
 
 		/**
@@ -78,52 +106,1138 @@ namespace divvy{
 		template <class T, typename = is_valid_component<T>>
 		inline bool has()
 		{
-			if (m_registry.find(typeid(T)) == m_registry.end())
-				return false;
-			return true;
+			return pool<T>() != nullptr;
+		}
+
+		/**
+		* Unregister a Component type in this World.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		void remove()
+		{
+			if (m_spatialType && *m_spatialType == typeid(T))
+			{
+				m_spatial.reset();
+				m_spatialType = nullptr;
+			}
+
+			auto it = m_registry.find(typeid(T));
+
+			if (it != m_registry.end())
+				m_pipeline.unassign(*it->second);
+
+			m_indexes.erase(typeid(T));
+			m_histories.erase(typeid(T));
+			m_registry.erase(typeid(T));
+
+			if (typeID<T>() < m_pools.size())
+				m_pools[typeID<T>()] = nullptr;
+
+			DIVVY_LOG(Info, "Unregistered Component type", typeid(T).name(), LogRecord::none());
+		}
+
+		/**
+		* Clear the World of all Entities and Components.
+		*/
+		void clear()
+		{
+			// Uninitialize every Entity in this World
+			m_entities.each([](Entity& entity)
+			{
+				entity.m_id = 0;
+				entity.m_world = nullptr;
+			});
+
+			// Unregister all Components along with their indexes
+			m_spatial.reset();
+			m_spatialType = nullptr;
+			m_indexes.clear();
+			m_histories.clear();
+			m_pipeline.clearPools();
+			m_registry.clear();
+			m_pools.clear();
+
+			// Destroy all singletons and events
+			m_singletons.clear();
+			m_events.clear();
+
+			// Remove all parent/child links
+			m_hierarchy.clear();
+			m_hierarchy.resize(m_entities.size());
+
+			// Remove all relation pairs
+			m_relations.clear();
+			m_relationKinds.clear();
+
+			// Saved frames went with the pools
+			m_kept = 0;
+		}
+
+		/**
+		* Declare a secondary index over a value of a registered Component type.
+		* The index is kept up to date as Components are added, mutated, and removed, and
+		* extracts every value again after Components are written without tracking.
+		*
+		* @param extract   Function extracting the indexed value from a Component.
+		*
+		* @return          Reference to the index, valid until the Component type is removed.
+		*/
+		template <class Index>
+		Index& index(typename Index::Extractor extract)
+		{
+			typedef typename Index::component_type T;
+
+			if (!has<T>())
+				throw std::runtime_error("Component not registered - call World.add<T>() beforehand");
+
+			auto& pool = static_cast<pool_type<T>&>(*m_registry.at(typeid(T)));
+			std::unique_ptr<Index> index = make_unique<Index>(pool, extract);
+			Index& result = *index;
+
+			pool.listen(result);
+			m_indexes[typeid(T)].push_back(std::move(index));
+
+			return result;
+		}
+
+		/**
+		* Create an Entity from a prefab, reusing the slot of a removed Entity that was
+		* recycled from the same prefab whenever possible. A reused slot still holds the
+		* Components of its previous Entity, so they are reinitialized in place through
+		* clone(), and heap buffers such as strings and vectors keep their memory.
+		*
+		* @param prefab    The Entity to clone, existing in this World.
+		*
+		* @return          The newly created Entity.
+		*/
+		Entity recycle(const Entity& prefab)
+		{
+			if (prefab.m_world != this || !hasEntity(prefab))
+				throw std::runtime_error("Prefab has to exist in this World to recycle from it");
+
+			Entity entity;
+			entity.m_world = this;
+
+			if (prefab.m_id < m_prefabs.size() && !m_prefabs[prefab.m_id].warm.empty())
+			{
+				entity.m_id = m_prefabs[prefab.m_id].warm.back();   // Reuse a warm slot
+				m_prefabs[prefab.m_id].warm.pop_back();
+				m_entities.bind(entity.m_id, entity);
+
+				m_stats.created++;
+				m_stats.reused++;
+
+				DIVVY_LOG(Debug, "Added Entity", "(recycled)", entity.m_id);
+			}
+			else
+			{
+				entity.m_id = addEntity(entity);
+			}
+
+			// Reinitialize the prefab's Components in place
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+			{
+				if (it->second->has(prefab.m_id))
+				{
+					it->second->clone(entity.m_id, entity, *it->second, prefab.m_id);
+					it->second->churn().added(m_stats.tick);
+				}
+			}
+
+			if (prefab.m_id >= m_prefabs.size())
+				m_prefabs.resize(prefab.m_id + 1);
+
+			std::vector<size_t>& children = m_prefabs[prefab.m_id].children;
+
+			m_origin.at(entity.m_id) = prefab.m_id;
+			m_sibling.at(entity.m_id) = children.size();
+			children.push_back(entity.m_id);
+
+			return entity;
+		}
+
+		/**
+		* Move an Entity to another World, along with its Components of the types registered
+		* in both Worlds. Components are moved rather than cloned: relocatable types are
+		* copied as raw bytes, other types are move assigned. The Entity's slot in this World
+		* is freed, while the Entity object stays valid and now refers to the other World.
+		* Hierarchy links and relation pairs do not cross Worlds and are dropped.
+		*
+		* @param entity    The Entity to move, existing in this World.
+		* @param other     The World to move it to.
+		*/
+		void migrate(Entity& entity, World& other)
+		{
+			migrate(&entity, &entity + 1, other);
+		}
+
+		/**
+		* Move a range of Entities to another World, pairing up the pools of both Worlds
+		* only once for the whole range.
+		*
+		* @param begin     Iterator to the first Entity, dereferencing to Entity& or Entity*.
+		* @param end       Iterator past the last Entity.
+		* @param other     The World to move them to.
+		*/
+		template <class Iterator>
+		void migrate(Iterator begin, Iterator end, World& other)
+		{
+			for (Iterator it = begin; it != end; ++it)
+			{
+				Entity& entity = deref(*it);
+
+				if (entity.m_world != this || !hasEntity(entity))
+					throw std::runtime_error("Entity has to exist in this World to migrate it");
+			}
+
+			if (&other == this)
+				return;
+
+			// Pair up the pools of the Component types registered in both Worlds
+			std::vector<std::pair<BaseComponentPool*, BaseComponentPool*>> pools;
+
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+			{
+				auto target = other.m_registry.find(it->first);
+
+				if (target != other.m_registry.end())
+					pools.push_back(std::make_pair(it->second.get(), target->second.get()));
+			}
+
+			for (Iterator it = begin; it != end; ++it)
+			{
+				Entity& entity = deref(*it);
+				size_t from = entity.m_id;
+				bool enabled = isEnabled(from);
+				EntityID id = other.addEntity(entity);
+
+				for (size_t i = 0; i < pools.size(); i++)
+				{
+					BaseComponentPool& source = *pools[i].first;
+					BaseComponentPool& target = *pools[i].second;
+
+					if (!source.has(from))
+						continue;
+
+					target.relocate(id, entity, source, from);
+					target.setEnabled(id, source.enabled(from));
+					target.churn().added(other.m_stats.tick);
+					source.churn().removed(m_stats.tick);
+				}
+
+				DIVVY_LOG(Debug, "Migrated Entity", "", from);
+
+				removeEntity(entity);   // Drops the Components left behind, frees the slot
+
+				entity.m_world = &other;
+				entity.m_id = id;
+
+				if (!enabled)
+					other.setEntityEnabled(entity, false);
+			}
+		}
+
+		/**
+		* Run a function on every Entity whose indexed value equals the one given.
+		*
+		* @param index     The index to look in.
+		* @param key       The value to look for.
+		* @param fn        Function taking (Entity& entity).
+		*/
+		template <class Index, class Func>
+		void find(Index& index, const typename Index::key_type& key, Func fn)
+		{
+			const BaseComponentPool& pool = *m_registry.at(typeid(typename Index::component_type));
+			const std::vector<size_t>& found = index.find(key);
+
+			for (size_t i = 0; i < found.size(); i++)
+				if (isEnabled(found[i]) && pool.enabled(found[i]))
+					fn(m_entities[found[i]]);
+		}
+
+		/**
+		* Run a function on every Entity whose indexed value lies within a range.
+		*
+		* @param index     The ordered index to look in.
+		* @param low       The lowest value included.
+		* @param high      The highest value included.
+		* @param fn        Function taking (Entity& entity).
+		*/
+		template <class Index, class Func>
+		void range(Index& index, const typename Index::key_type& low, const typename Index::key_type& high, Func fn)
+		{
+			const BaseComponentPool& pool = *m_registry.at(typeid(typename Index::component_type));
+
+			index.range(low, high, [&](size_t found)
+			{
+				if (isEnabled(found) && pool.enabled(found))
+					fn(m_entities[found]);
+			});
+		}
+
+		/**
+		* Designate a position Component and build a spatial index over it, replacing
+		* any previous spatial index. The index is kept up to date as Components are
+		* added, mutated, and removed.
+		*
+		* @param args      Arguments to feed to the index's constructor after the pool,
+		*                  such as the cell size and position extractor of a SpatialGrid.
+		*
+		* @return          Reference to the index, valid until it is replaced or the
+		*                  Component type is removed.
+		*/
+		template <class Index, class ... Args>
+		Index& spatial(Args&& ... args)
+		{
+			typedef typename Index::component_type T;
+
+			if (!has<T>())
+				throw std::runtime_error("Component not registered - call World.add<T>() beforehand");
+
+			auto& pool = static_cast<pool_type<T>&>(*m_registry.at(typeid(T)));
+
+			if (m_spatial)
+				m_registry.at(*m_spatialType)->unlisten(*m_spatial);
+
+			std::unique_ptr<Index> index = make_unique<Index>(pool, std::forward<Args>(args)...);
+			Index& result = *index;
+
+			pool.listen(result);
+			m_spatial = std::move(index);
+			m_spatialType = &typeid(T);
+
+			return result;
+		}
+
+		/**
+		* Run a function on every Entity within a radius of a point.
+		*
+		* @param center    The center of the circle.
+		* @param radius    The radius of the circle.
+		* @param fn        Function taking (Entity& entity).
+		*/
+		template <class Func>
+		void queryRadius(Point center, float radius, Func fn)
+		{
+			if (!m_spatial)
+				throw std::runtime_error("No spatial index - call World.spatial<Index>() beforehand");
+
+			std::vector<size_t> found;
+			found.swap(m_found);    // Reuse the buffer, unless queries are nested
+			found.clear();
+
+			m_spatial->queryRadius(center, radius, found);
+
+			const BaseComponentPool& pool = *m_registry.at(*m_spatialType);
+
+			for (size_t i = 0; i < found.size(); i++)
+				if (isEnabled(found[i]) && pool.enabled(found[i]))
+					fn(m_entities[found[i]]);
+
+			found.swap(m_found);
+		}
+
+		/**
+		* Run a function on every Entity within an axis-aligned bounding box.
+		*
+		* @param low       The corner of the box with the lowest coordinates.
+		* @param high      The corner of the box with the highest coordinates.
+		* @param fn        Function taking (Entity& entity).
+		*/
+		template <class Func>
+		void queryAABB(Point low, Point high, Func fn)
+		{
+			if (!m_spatial)
+				throw std::runtime_error("No spatial index - call World.spatial<Index>() beforehand");
+
+			std::vector<size_t> found;
+			found.swap(m_found);    // Reuse the buffer, unless queries are nested
+			found.clear();
+
+			m_spatial->queryAABB(low, high, found);
+
+			const BaseComponentPool& pool = *m_registry.at(*m_spatialType);
+
+			for (size_t i = 0; i < found.size(); i++)
+				if (isEnabled(found[i]) && pool.enabled(found[i]))
+					fn(m_entities[found[i]]);
+
+			found.swap(m_found);
+		}
+
+		/**
+		* Run a function on every target that an Entity relates to.
+		* The relation pairs must not be modified while running.
+		*
+		* @param source    Reference to the source Entity.
+		* @param fn        Function taking (Entity& target).
+		*/
+		template <class R, class Func>
+		void targets(const Entity& source, Func fn)
+		{
+			if (!hasEntity(source) || source.m_world != this)
+				throw std::runtime_error("Entity non-existent - call Entity.reset() beforehand");
+
+			const std::vector<size_t>& targets = relation<R>().targets(source.m_id);
+
+			for (size_t i = 0; i < targets.size(); i++)
+				if (isEnabled(targets[i]))
+					fn(m_entities[targets[i]]);
+		}
+
+		/**
+		* Run a function on every source that relates to an Entity, such as everything
+		* that targets it. The relation pairs must not be modified while running.
+		*
+		* @param target    Reference to the target Entity.
+		* @param fn        Function taking (Entity& source).
+		*/
+		template <class R, class Func>
+		void sources(const Entity& target, Func fn)
+		{
+			if (!hasEntity(target) || target.m_world != this)
+				throw std::runtime_error("Entity non-existent - call Entity.reset() beforehand");
+
+			const std::vector<size_t>& sources = relation<R>().sources(target.m_id);
+
+			for (size_t i = 0; i < sources.size(); i++)
+				if (isEnabled(sources[i]))
+					fn(m_entities[sources[i]]);
+		}
+
+		/**
+		* Retrieve a world-global singleton, creating it if it doesn't exist yet.
+		* Singletons are stored outside of the Component pools and are indexed directly
+		* by type, so access is constant time.
+		*
+		* @return          Reference to the singleton.
+		*/
+		template <class T>
+		inline T& singleton()
+		{
+			size_t id = typeID<T>();
+
+			if (id >= m_singletons.size() || !m_singletons[id])
+				return setSingleton<T>();
+
+			return static_cast<Singleton<T>&>(*m_singletons[id]).get();
+		}
+
+		/**
+		* Create or replace a world-global singleton.
+		*
+		* @param args      Arguments to feed to the singleton's constructor.
+		*
+		* @return          Reference to the singleton.
+		*/
+		template <class T, class ... Args>
+		T& setSingleton(Args&& ... args)
+		{
+			size_t id = typeID<T>();
+
+			if (id >= m_singletons.size())
+				m_singletons.resize(id + 1);
+
+			m_singletons[id] = make_unique<Singleton<T>>(std::forward<Args>(args)...);
+
+			return static_cast<Singleton<T>&>(*m_singletons[id]).get();
+		}
+
+		/**
+		* Check whether a world-global singleton exists.
+		*
+		* @return          True if the singleton exists, false otherwise.
+		*/
+		template <class T>
+		inline bool hasSingleton() const
+		{
+			size_t id = typeID<T>();
+			return id < m_singletons.size() && m_singletons[id];
+		}
+
+		/**
+		* Destroy a world-global singleton.
+		*/
+		template <class T>
+		void removeSingleton()
+		{
+			size_t id = typeID<T>();
+
+			if (id < m_singletons.size())
+				m_singletons[id].reset();
+		}
+
+		/**
+		* Run a function on every Entity with a shared Component, grouped by value.
+		* All Entities sharing a value are visited one after another, so per-value work
+		* can be done once per group.
+		*
+		* @param fn        Function taking (const T& value, Entity& entity).
+		*/
+		template <class T, class Func, typename = typename std::enable_if<is_shared<T>::value>::type>
+		void group(Func fn)
+		{
+			if (!has<T>())
+				throw std::runtime_error("Component not registered - call World.add<T>() beforehand");
+
+			auto& pool = static_cast<SharedPool<T>&>(*m_registry.at(typeid(T)));
+
+			pool.each([&](const T& value, const std::vector<size_t>& members)
+			{
+				for (size_t i = 0; i < members.size(); i++)
+					if (isEnabled(members[i]) && pool.enabled(members[i]))
+						fn(value, m_entities[members[i]]);
+			});
+		}
+
+		/**
+		* Run a function on every Entity that is part of a hierarchy, in breadth-first
+		* order. Parents are always visited before their children.
+		*
+		* @param fn        Function taking (Entity& entity).
+		*/
+		template <class Func>
+		void traverse(Func fn)
+		{
+			const std::vector<size_t>& order = m_hierarchy.order();
+
+			for (size_t i = 0; i < order.size(); i++)
+				if (isEnabled(order[i]))
+					fn(m_entities[order[i]]);
+		}
+
+		/**
+		* Propagate a Component from parents to children, such as local to world transforms.
+		* The hierarchy is swept linearly in breadth-first order, so a parent's Component
+		* is always final by the time its children are visited. Pairs where either
+		* Entity lacks the Component, or either is disabled, are skipped.
+		*
+		* @param fn        Function taking (T& parent, T& child).
+		*/
+		template <class T, class Func, typename = is_valid_component<T>>
+		void propagate(Func fn)
+		{
+			if (!has<T>())
+				throw std::runtime_error("Component not registered - call World.add<T>() beforehand");
+
+			auto& pool = static_cast<pool_type<T>&>(*m_registry.at(typeid(T)));
+			const std::vector<size_t>& order = m_hierarchy.order();
+
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				size_t parent = m_hierarchy.parent(order[i]);
+
+				if (parent != Hierarchy::npos && pool.has(parent) && pool.has(order[i]) &&
+					isEnabled(parent) && isEnabled(order[i]) && pool.enabled(parent) && pool.enabled(order[i]))
+				{
+					fn(pool.get(parent), pool.get(order[i]));
+				}
+			}
+		}
+
+		/**
+		* Move a registered Component type to another stage of the update.
+		*
+		* @param stage     The stage at which the Components are updated.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		void setStage(int stage)
+		{
+			if (!has<T>())
+				throw std::runtime_error("Component type is not registered, cannot set its stage");
+
+			m_pipeline.assign(*m_registry.at(typeid(T)), stage);
+		}
+
+		/**
+		* Add a system, run once per update at the given stage. Within a stage, systems and
+		* Component types run in the order in which they were added.
+		*
+		* @param fn        Function taking (World& world).
+		* @param stage     The stage of the update at which the system runs.
+		*/
+		void system(std::function<void(World&)> fn, int stage = Stage::Update)
+		{
+			m_pipeline.add([this, fn]() { fn(*this); }, stage);
+		}
+
+		/**
+		* Create an Accessor, retrieving Components of a type in constant time.
+		*
+		* @return          Accessor over the pool of the Component type.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		Accessor<T> accessor()
+		{
+			if (!has<T>())
+				throw std::runtime_error("Component type is not registered, cannot access it");
+
+			return Accessor<T>(static_cast<pool_type<T>&>(*m_registry.at(typeid(T))), this);
+		}
+
+		/**
+		* Run a function on every contiguous span of active, enabled Components of a type,
+		* straight over the pool's aligned storage. With a chunk size, spans are split at
+		* aligned boundaries, so chunks of different aligned blocks never share a cache line.
+		* Chunks of neighbouring spans within the same block may, since a span starts
+		* wherever its first active Component is.
+		*
+		* @param fn        Function taking (T* begin, T* end).
+		* @param chunk     Least number of Components per chunk, or 0 to not split spans.
+		*/
+		template <class T, class Func>
+		void spans(Func fn, size_t chunk = 0)
+		{
+			static_assert(!is_tag<T>::value && !is_shared<T>::value,
+				"Tags and shared Components are not stored contiguously");
+
+			if (!has<T>())
+				throw std::runtime_error("Component type is not registered, cannot iterate over it");
+
+			auto& pool = static_cast<ComponentPool<T>&>(*m_registry.at(typeid(T)));
+			pool.spans(m_disabled, chunk, fn);
+		}
+
+		/**
+		* Run a function on every registered Component type, without knowing the types.
+		*
+		* @param fn        Function taking (const ComponentType& type).
+		*/
+		template <class Func>
+		void types(Func fn)
+		{
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+				fn(ComponentType(*it->second, this));
+		}
+
+		/**
+		* Retrieve a registered Component type, without knowing the type.
+		*
+		* @param type      The type to retrieve, such as typeid(Transform).
+		*
+		* @return          View of the Component type.
+		*/
+		ComponentType type(const std::type_index& type)
+		{
+			auto it = m_registry.find(type);
+
+			if (it == m_registry.end())
+				throw std::runtime_error("Component type is not registered, cannot reflect it");
+
+			return ComponentType(*it->second, this);
+		}
+
+		/**
+		* Run a function on every Component type an Entity has, without knowing the types.
+		*
+		* @param entity    The Entity to inspect.
+		* @param fn        Function taking (const ComponentType& type, const void* bytes).
+		*/
+		template <class Func>
+		void components(const Entity& entity, Func fn)
+		{
+			if (!hasEntity(entity))
+				throw std::runtime_error("Entity non-existent, cannot inspect its Components");
+
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+				if (it->second->has(entity.m_id))
+					fn(ComponentType(*it->second, this), it->second->bytes(entity.m_id));
+		}
+
+		/**
+		* Compute a deterministic hash of the World's state, to compare Worlds across peers
+		* such as in lockstep multiplayer. It covers the number of Entities, which Entities
+		* have a Component of each type, and the values of the Components. Components are
+		* hashed through their `uint64_t hash() const` method, or by their bytes when their
+		* type is marked with is_byte_hashable. Hashing any other Component type throws.
+		*
+		* The hashes of the pools are summed, so that the result doesn't depend on the
+		* order the types are stored in, which differs across platforms. Only Components
+		* retrieved for writing since the previous call are hashed again, except for types
+		* that have an update, whose pools are hashed as a whole after every update.
+		*
+		* @return          The hash of the World.
+		*/
+		uint64_t hash()
+		{
+			uint64_t result = hash::mix(m_entities.count());
+
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+				result += it->second->hash();
+
+			return result;
+		}
+
+		/**
+		* Run a function on the hash of every Component type, to find the types whose
+		* state diverged when the hashes of two Worlds differ.
+		*
+		* @param fn        Function taking (const ComponentType& type, uint64_t hash).
+		*/
+		template <class Func>
+		void hashes(Func fn)
+		{
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+				fn(ComponentType(*it->second, this), it->second->hash());
+		}
+
+		/**
+		* Retrieve the generation of an Entity's slot. Together with the EntityID, it
+		* identifies the Entity even after its slot is reused by another Entity.
+		*
+		* @param entity    Reference to the existing Entity.
+		*
+		* @return          The generation of the Entity.
+		*/
+		size_t generation(const Entity& entity)
+		{
+			if (entity.m_world != this || !hasEntity(entity))
+				throw std::runtime_error("Entity non-existent - call hasEntity() beforehand");
+
+			return m_entities.generation(entity.m_id);
+		}
+
+		/**
+		* Look up an Entity by its EntityID and generation, in constant time.
+		*
+		* @param id        The EntityID of the Entity.
+		* @param generation The generation retrieved through generation().
+		*
+		* @return          Pointer to the Entity, or nullptr if it was removed since.
+		*/
+		Entity* lookup(EntityID id, size_t generation)
+		{
+			if (!m_entities.alive(id) || m_entities.generation(id) != generation)
+				return nullptr;
+
+			return &m_entities[id];
+		}
+
+		/**
+		* Retrieve the lifecycle statistics of the previous tick. A tick runs from the start
+		* of one update, or frame, to the start of the next.
+		*
+		* @return          Statistics of the previous tick.
+		*/
+		const TickStats& stats() const
+		{
+			return m_lastStats;
+		}
+
+		/**
+		* Retrieve how many Components of a type were added and removed during the
+		* previous tick.
+		*
+		* @return          Churn of the Component type during the previous tick.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		ComponentStats stats()
+		{
+			if (!has<T>())
+				throw std::runtime_error("Component type is not registered, cannot retrieve its statistics");
+
+			return m_registry.at(typeid(T))->churn().last(m_stats.tick);
+		}
+
+		/**
+		* Keep earlier states of the World's Components in a ring of frames, to roll back
+		* to, such as when rollback netcode mispredicted.
+		*
+		* @param frames    Number of frames kept, or 0 to stop keeping them.
+		*/
+		void setRollback(size_t frames)
+		{
+			m_rollback = frames;
+			m_kept = 0;
+		}
+
+		/**
+		* Save the state of every Component as a new frame, forgetting the oldest frame
+		* once the ring is full. Only the pages of Component storage changed since the
+		* previous save are copied.
+		*
+		* @return          The number of the frame, to restore it later.
+		*/
+		size_t save()
+		{
+			if (!m_rollback)
+				throw std::runtime_error("Rollback not enabled - call World.setRollback() beforehand");
+
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+				it->second->churn().saved(m_stats.tick, it->second->save(m_rollback));
+
+			m_kept = std::min(m_kept + 1, m_rollback);
+
+			return m_frame++;
+		}
+
+		/**
+		* Restore the state every Component had when a frame was saved, discarding the
+		* frames saved after it. Entities are neither created nor removed: Components of
+		* Entities removed since are dropped, and Entities created since are left with the
+		* Components their slot held. Hierarchies, relations, and singletons are kept.
+		*
+		* @param frame     The number of the frame, as returned by save().
+		*/
+		void restore(size_t frame)
+		{
+			if (frame >= m_frame || m_frame - frame > m_kept)
+				throw std::runtime_error("Frame is not kept, cannot restore it");
+
+			size_t steps = m_frame - 1 - frame;
+			std::vector<std::pair<size_t, size_t>> restored;
+
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+			{
+				BaseComponentPool& pool = *it->second;
+
+				restored.clear();
+				pool.restore(steps, restored);
+
+				// Restored Components have to point to the Entities now in their slots
+				for (size_t r = 0; r < restored.size(); r++)
+				{
+					for (size_t i = restored[r].first; i < restored[r].second; i++)
+					{
+						if (!pool.has(i))
+							continue;
+
+						if (m_entities.alive(i))
+							pool.rebind(i, m_entities[i]);
+						else
+							pool.remove(i);
+					}
+				}
+			}
+
+			m_kept -= steps;
+			m_frame = frame + 1;
+
+			DIVVY_LOG(Debug, "Restored frame", "", LogRecord::none());
+		}
+
+		/**
+		* Keep the statistics of the latest ticks in a ring buffer.
+		*
+		* @param ticks     Number of ticks kept, or 0 to stop keeping them.
+		*/
+		void sampleStats(size_t ticks)
+		{
+			if (ticks)
+				m_history = make_unique<StatsHistory>(ticks);
+			else
+				m_history.reset();
+		}
+
+		/**
+		* Run a function on the statistics of every tick kept, oldest first.
+		*
+		* @param fn        Function taking (const TickStats& stats).
+		*/
+		template <class Func>
+		void statsHistory(Func fn) const
+		{
+			if (m_history)
+				m_history->each(fn);
+		}
+
+		/**
+		* Set how often a stage runs when the World is driven by a Runner. Stages run at a
+		* fixed rate by default.
+		*
+		* @param stage     The stage to set the rate of.
+		* @param rate      How often the stage runs.
+		*/
+		void setRate(int stage, Rate rate)
+		{
+			m_pipeline.setRate(stage, rate);
+		}
+
+		/**
+		* Update all the Components in this World, stage by stage.
+		*/
+		void update()
+		{
+			step(true, true);
+		}
+
+		/**
+		* Update only the stages running at the given rate. Within a frame, only the stages
+		* are run, see beginFrame().
+		*
+		* @param rate      The rate of the stages to update.
+		*/
+		void update(Rate rate)
+		{
+			step(rate == Rate::Fixed, rate == Rate::Variable);
+		}
+
+		/**
+		* Begin a frame made of several updates, such as the fixed steps and the variable
+		* step of a Runner. The frame counts as a single tick: events are swapped and handed
+		* to the PreUpdate listeners once here, and to the PostUpdate listeners once in
+		* endFrame(). Previous values of interpolated types are not saved by the updates of
+		* a frame, call savePrevious() before the last fixed step instead.
+		*/
+		void beginFrame()
+		{
+			if (m_framing)
+				throw std::runtime_error("Frame already begun, call World.endFrame() first");
+
+			open();
+			m_framing = true;
+		}
+
+		/**
+		* End the frame begun by beginFrame().
+		*/
+		void endFrame()
+		{
+			if (!m_framing)
+				throw std::runtime_error("No frame begun, call World.beginFrame() first");
+
+			m_framing = false;
+			dispatch(EventPhase::PostUpdate);
+		}
+
+		/**
+		* Keep the current values of every interpolated Component type as their previous
+		* values.
+		*/
+		void savePrevious()
+		{
+			for (auto it = m_histories.begin(); it != m_histories.end(); it++)
+				it->second->save();
+		}
+
+		/**
+		* Keep the previous values of a Component type around, so they can be interpolated
+		* with the current values. The previous values are saved before every fixed step,
+		* or before the last fixed step of a frame.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		void interpolate()
+		{
+			if (!has<T>())
+				throw std::runtime_error("Component type is not registered, cannot interpolate it");
+
+			auto& pool = static_cast<pool_type<T>&>(*m_registry.at(typeid(T)));
+			m_histories[typeid(T)] = make_unique<History<T>>(pool);
+		}
+
+		/**
+		* Retrieve the value a Component had before the last fixed step.
+		*
+		* @param entity    The Entity that has the Component.
+		*
+		* @return          The previous value of the Component.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		const T& previous(const Entity& entity)
+		{
+			if (!hasComponent<T>(entity))
+				throw std::runtime_error("Component does not exist, cannot retrieve its previous value");
+
+			auto it = m_histories.find(typeid(T));
+
+			if (it == m_histories.end())
+				throw std::runtime_error("Component type is not interpolated, cannot retrieve its previous value");
+
+			return static_cast<const History<T>&>(*it->second).previous(entity.m_id);
+		}
+
+		/**
+		* Emit an event. Events are appended to a contiguous buffer per event type and
+		* become readable, in a single batch, on the next update.
+		*
+		* @param args      Arguments to feed to the event's constructor.
+		*/
+		template <class E, class ... Args>
+		inline void emit(Args&& ... args)
+		{
+			queue<E>().emit(std::forward<Args>(args)...);
+		}
+
+		/**
+		* Listen to an event type. The listener receives every event emitted during the
+		* previous frame at once, at the given phase of each update.
+		*
+		* @param fn        Function taking (const std::vector<E>& events).
+		* @param phase     The phase of the update at which the listener is run.
+		*/
+		template <class E>
+		void listen(typename EventQueue<E>::Listener fn, EventPhase phase = EventPhase::PreUpdate)
+		{
+			queue<E>().listen(phase, std::move(fn));
+		}
+
+		/**
+		* Access the readable events of a type, which were emitted during the previous frame.
+		*
+		* @return          The readable events.
+		*/
+		template <class E>
+		const std::vector<E>& events()
+		{
+			return queue<E>().events();
+		}
+
+	private:
+		/**
+		* Retrieve the queue of an event type, creating it if it doesn't exist yet.
+		*
+		* @return          Reference to the queue.
+		*/
+		template <class E>
+		inline EventQueue<E>& queue()
+		{
+			size_t id = typeID<E>();
+
+			if (id >= m_events.size())
+				m_events.resize(id + 1);
+
+			if (!m_events[id])
+				m_events[id] = make_unique<EventQueue<E>>();
+
+			return static_cast<EventQueue<E>&>(*m_events[id]);
+		}
+
+		/**
+		* Run the stages of the given rates, as a frame of its own unless one was begun.
+		*/
+		void step(bool fixed, bool variable)
+		{
+			if (m_framing)
+			{
+				m_pipeline.run(m_disabled, fixed, variable);
+				return;
+			}
+
+			open();
+
+			if (fixed)
+				savePrevious();
+
+			// Removed Entities have their Components deactivated, so every pool only has to
+			// update its own active Components, skipping disabled ones.
+			m_pipeline.run(m_disabled, fixed, variable);
+
+			dispatch(EventPhase::PostUpdate);
+		}
+
+		/**
+		* Start a frame: a new tick, and a new batch of readable events.
+		*/
+		void open()
+		{
+			// Every frame starts a new tick
+			m_stats.entities = m_entities.count();
+			m_lastStats = m_stats;
+
+			if (m_history)
+				m_history->push(m_stats);
+
+			m_stats = TickStats();
+			m_stats.tick = m_lastStats.tick + 1;
+
+			// Events emitted since the last update become readable
+			for (size_t i = 0; i < m_events.size(); i++)
+				if (m_events[i])
+					m_events[i]->swap();
+
+			dispatch(EventPhase::PreUpdate);
+		}
+
+		/**
+		* Accept ranges of both Entities and pointers to Entities.
+		*/
+		static Entity& deref(Entity& entity)
+		{
+			return entity;
+		}
+
+		static Entity& deref(Entity* entity)
+		{
+			return *entity;
+		}
+
+		/**
+		* Hand the readable events to the listeners of a phase.
+		*
+		* @param phase     The phase whose listeners are run.
+		*/
+		void dispatch(EventPhase phase)
+		{
+			for (size_t i = 0; i < m_events.size(); i++)
+				if (m_events[i])
+					m_events[i]->dispatch(phase);
+		}
+
+		/**
+		* Check whether an Entity is enabled.
+		*
+		* @param index     The EntityID of the Entity.
+		*
+		* @return          True if enabled, false otherwise.
+		*/
+		inline bool isEnabled(size_t index) const
+		{
+			return index >= m_disabled.size() || !m_disabled[index];
+		}
+
+		/**
+		* Enable or disable an Entity without removing it or its Components.
+		*
+		* @param entity    Reference to the target Entity.
+		* @param enabled   Whether the Entity should be enabled.
+		*/
+		void setEntityEnabled(const Entity& entity, bool enabled)
+		{
+			if (!hasEntity(entity))
+				throw std::runtime_error("Entity non-existent - call Entity.reset() beforehand");
+
+			if (entity.m_id >= m_disabled.size())
+			{
+				if (enabled)
+					return;
+
+				m_disabled.resize(m_entities.size(), false);
+			}
+
+			m_disabled[entity.m_id] = !enabled;
 		}
 
 		/**
-		* Unregister a Component type in this World.
+		* Enable or disable an Entity's Component without removing it.
+		*
+		* @param entity    Reference to the target Entity.
+		* @param enabled   Whether the Component should be enabled.
 		*/
 		template <class T, typename = is_valid_component<T>>
-		void remove()
+		void setComponentEnabled(const Entity& entity, bool enabled)
 		{
-			m_registry.erase(typeid(T));
-
-#ifdef DIVVY_DEBUG
-			std::cout << "-- Registered Component Type: " << typeid(T).name() << std::endl;
-#endif
-		}
+			if (!hasEntity(entity))
+				throw std::runtime_error("Entity non-existent - call hasEntity() beforehand");
 
-		/**
-		* Clear the World of all Entities and Components.
-		*/
-		void clear()
-		{
-			// Uninitialize every Entity in this World
-			for (Entity& entity : m_entities)
-			{
-				entity.m_id = 0;
-				entity.m_world = nullptr;
-			}
+			if (!hasComponent<T>(entity))
+				throw std::runtime_error("Component non-existent - call hasComponent() beforehand");
 
-			// Unregister all Components
-			m_registry.clear();
+			m_registry.at(typeid(T))->setEnabled(entity.m_id, enabled);
 		}
 
 		/**
-		* Update all the Components in this World.
+		* Check whether an Entity's Component is enabled.
+		*
+		* @param entity    Reference to the target Entity.
+		*
+		* @return          True if the Component exists and is enabled, false otherwise.
 		*/
-		void update()
+		template <class T, typename = is_valid_component<T>>
+		bool isComponentEnabled(const Entity& entity)
 		{
-			for (auto it = m_registry.begin(); it != m_registry.end(); it++)          // For every Component type
-				for (unsigned int i = 0; i < m_capacity; i++)                         // In the capacity range
-					if (it->second->has(i) == true && m_open.find(i) == m_open.end()) // That is active and existing
-						it->second->at(i).update();                                   // Update.
+			return hasEntity(entity) && hasComponent<T>(entity) && m_registry.at(typeid(T))->enabled(entity.m_id);
 		}
 
-	private:
 		/**
 		* Check whether an Entity is nonexistent or null.
 		*
@@ -133,9 +1247,7 @@ namespace divvy{
 		*/
 		inline bool hasEntity(const Entity& entity)
 		{
-			if (m_open.find(entity.m_id) != m_open.end() || m_capacity <= entity.m_id)
-				return false;
-			return true;
+			return m_entities.alive(entity.m_id);
 		}
 
 		/**
@@ -148,15 +1260,8 @@ namespace divvy{
 		template <class T, typename = is_valid_component<T>>
 		inline bool hasComponent(const Entity& entity)
 		{
-			if (m_registry.find(typeid(T)) == m_registry.end() ||
-				!m_registry.at(typeid(T))->has(entity.m_id))
-			{
-				return false;
-			}
-			else
-			{
-				return true;
-			}
+			pool_type<T>* found = pool<T>();
+			return found && found->has(entity.m_id);
 		}
 
 		/**
@@ -168,35 +1273,37 @@ namespace divvy{
 		*/
 		EntityID addEntity(Entity& entity)
 		{
-			size_t index;
+			bool reused = m_entities.reusable();
+			size_t index = m_entities.acquire(entity);
 
-			if (m_open.size() != 0)             // Free m_capacity available - reuse slots
+			if (reused)                         // Reused the slot of a removed Entity
 			{
-				index = *(m_open.begin());      // Set index to open slot
-				m_open.erase(m_open.begin());   // Remove open slots
-				m_entities.at(index) = entity;  // Add to Entity collection
+				m_stats.reused++;
 
-#ifdef DIVVY_DEBUG
-				std::cout << "-- Added new Entity at #" << index << " (reused)" << std::endl;
-#endif
+				DIVVY_LOG(Debug, "Added Entity", "(reused)", index);
 			}
-			else                                // No open slots available - allocate more slots
+			else                                // Added a slot - allocate more room
 			{
-				m_capacity++;                   // Increase capacity
+				size_t capacity = m_entities.size();
 
 												// Resize ComponentRegistry
 				for (auto it = m_registry.begin(); it != m_registry.end(); it++)
-					it->second->resize(m_capacity);
+				{
+					size_t allocated = it->second->allocated();
+					it->second->resize(capacity);
 
-				index = m_capacity - 1;         // Set index to newly allocated slot
-				m_entities.push_back(entity);   // Push to Entity collection
+					if (it->second->allocated() != allocated)
+						m_stats.resizes++;
+				}
+
+				m_hierarchy.resize(capacity);   // Resize Hierarchy
+				m_origin.resize(capacity, npos());
+				m_sibling.resize(capacity, npos());
 
-#ifdef DIVVY_DEBUG
-				std::cout << "-- Added new Entity at #" << index << std::endl;
-#endif
+				DIVVY_LOG(Debug, "Added Entity", "", index);
 			}
 
-			m_count++; // Increase Entity count
+			m_stats.created++;
 
 			return index;
 		}
@@ -220,9 +1327,8 @@ namespace divvy{
 				{
 					if (it->second->has(other.m_id))
 					{
-						m_registry.at(it->first)->add(id);
-						m_registry.at(it->first)->at(id).clone(it->second->at(other.m_id));
-						m_registry.at(it->first)->at(id).m_entity = &entity;
+						it->second->clone(id, entity, *it->second, other.m_id);
+						it->second->churn().added(m_stats.tick);
 					}
 				}
 			}
@@ -234,9 +1340,8 @@ namespace divvy{
 					if (it->second->has(other.m_id) &&                  // For every Component
 						m_registry.find(it->first) != m_registry.end()) // also registered in this World
 					{
-						m_registry.at(it->first)->add(id);
-						m_registry.at(it->first)->at(id).clone(it->second->at(other.m_id));
-						m_registry.at(it->first)->at(id).m_entity = &entity;
+						m_registry.at(it->first)->clone(id, entity, *it->second, other.m_id);
+						m_registry.at(it->first)->churn().added(m_stats.tick);
 					}
 				}
 			}
@@ -254,33 +1359,210 @@ namespace divvy{
 			// Does the entity exist?
 			if (hasEntity(entity))
 			{
+				DIVVY_LOG(Debug, "Removed Entity", "", entity.m_id);
+				m_stats.destroyed++;
+
 				// Remove from ComponentRegisry
 				for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+				{
+					if (it->second->has(entity.m_id))
+						it->second->churn().removed(m_stats.tick);
+
 					it->second->remove(entity.m_id);
+					it->second->setEnabled(entity.m_id, true);
+				}
+
+				// Reset the slot to enabled for the next Entity
+				if (entity.m_id < m_disabled.size())
+					m_disabled[entity.m_id] = false;
+
+				// Remove from Hierarchy, children become roots
+				m_hierarchy.unlink(entity.m_id);
 
-				// Remove from Entity collection
-				m_entities.erase(m_entities.begin() + entity.m_id);
+				// Remove every relation pair the Entity takes part in
+				for (size_t i = 0; i < m_relationKinds.size(); i++)
+					m_relationKinds[i]->unlink(entity.m_id);
 
-				// Is top entity?
-				if (entity.m_id == m_capacity - 1)
-					m_capacity--;                   // Decrease capacity
+				size_t origin = m_origin.at(entity.m_id);
+
+				// Was recycled from a prefab?
+				if (origin != npos())
+				{
+					Prefab& prefab = m_prefabs.at(origin);
+
+					// Swap the last recycled Entity into the released position
+					size_t last = prefab.children.back();
+					prefab.children[m_sibling[entity.m_id]] = last;
+					m_sibling[last] = m_sibling[entity.m_id];
+					prefab.children.pop_back();
+
+					m_origin[entity.m_id] = npos();
+					m_sibling[entity.m_id] = npos();
+					prefab.warm.push_back(entity.m_id);       // Keep slot warm for the prefab
+					m_entities.release(entity.m_id, false);
+				}
 				else
-					m_open.insert(entity.m_id);     // Insert open slot
+					m_entities.release(entity.m_id);          // Open the slot for reuse
+
+				// Was used as a prefab? Its warm slots become regular open slots
+				if (entity.m_id < m_prefabs.size() &&
+					(!m_prefabs[entity.m_id].warm.empty() || !m_prefabs[entity.m_id].children.empty()))
+					retirePrefab(entity.m_id);
 
 													// Set Entity to uninitialized
 				entity.m_id = 0;
 				entity.m_world = nullptr;
+			}
+			else
+				DIVVY_LOG(Warning, "Entity is already non-existent", "", entity.m_id);
+		}
+
+		/**
+		* Release the warm slots kept for a removed prefab.
+		*
+		* @param prefab    The EntityID of the prefab.
+		*/
+		void retirePrefab(size_t prefab)
+		{
+			Prefab& retired = m_prefabs[prefab];
 
-				m_count--; // Size decrease
+			for (size_t i = 0; i < retired.warm.size(); i++)
+				m_entities.open(retired.warm[i]);
 
-#ifdef DIVVY_DEBUG
-				std::cerr << "-- Removed " << entity << std::endl;
-#endif
+			// Entities still alive that were recycled from it no longer belong to it
+			for (size_t i = 0; i < retired.children.size(); i++)
+			{
+				m_origin[retired.children[i]] = npos();
+				m_sibling[retired.children[i]] = npos();
 			}
-#ifdef DIVVY_DEBUG
-			else
-				std::cerr << "-- WARNING: " << entity << " is already non-existent" << std::endl;
-#endif
+
+			retired.warm.clear();
+			retired.children.clear();
+		}
+
+		/**
+		* Marks the absence of an Entity.
+		*/
+		static size_t npos()
+		{
+			return static_cast<size_t>(-1);
+		}
+
+		/**
+		* Remove an Entity along with all of its descendants.
+		*
+		* @param entity    Reference to the root of the subtree.
+		*/
+		void removeTree(Entity& entity)
+		{
+			if (!hasEntity(entity))
+				return removeEntity(entity);
+
+			std::vector<size_t> nodes = m_hierarchy.subtree(entity.m_id);
+
+			// Remove the deepest Entities first, so that their slots are reused last
+			for (size_t i = nodes.size(); i-- > 1;)
+				removeEntity(m_entities[nodes[i]]);
+
+			removeEntity(entity);
+		}
+
+		/**
+		* Attach an Entity to a parent Entity.
+		*
+		* @param entity    Reference to the child Entity.
+		* @param parent    Reference to the parent Entity.
+		*/
+		void setParent(Entity& entity, Entity& parent)
+		{
+			if (!hasEntity(entity) || parent.m_world != this || !hasEntity(parent))
+				throw std::runtime_error("Entities have to exist in the same World to be related");
+
+			m_hierarchy.attach(entity.m_id, parent.m_id);
+		}
+
+		/**
+		* Retrieve the parent of an Entity.
+		*
+		* @param entity    Reference to the child Entity.
+		*
+		* @return          Pointer to the parent Entity, or nullptr if there is none.
+		*/
+		Entity* getParent(const Entity& entity)
+		{
+			size_t parent = m_hierarchy.parent(entity.m_id);
+
+			if (!hasEntity(entity) || parent == Hierarchy::npos)
+				return nullptr;
+
+			return &m_entities[parent];
+		}
+
+		/**
+		* Retrieve the index of a relation type, creating it if it doesn't exist yet.
+		*
+		* @return          Reference to the relation's index.
+		*/
+		template <class R>
+		inline RelationIndex& relation()
+		{
+			size_t id = typeID<R>();
+
+			if (id >= m_relations.size())
+				m_relations.resize(id + 1);
+
+			if (!m_relations[id])
+			{
+				m_relations[id] = make_unique<RelationIndex>();
+				m_relationKinds.push_back(m_relations[id].get());
+			}
+
+			return *m_relations[id];
+		}
+
+		/**
+		* Relate a source Entity to a target Entity.
+		*
+		* @param source    Reference to the source Entity.
+		* @param target    Reference to the target Entity.
+		*/
+		template <class R>
+		void addRelation(const Entity& source, const Entity& target)
+		{
+			if (!hasEntity(source) || target.m_world != this || !hasEntity(target))
+				throw std::runtime_error("Entities have to exist in the same World to be related");
+
+			relation<R>().add(source.m_id, target.m_id);
+		}
+
+		/**
+		* Check whether a source Entity relates to a target Entity.
+		*
+		* @param source    Reference to the source Entity.
+		* @param target    Reference to the target Entity.
+		*
+		* @return          True if the pair exists, false otherwise.
+		*/
+		template <class R>
+		bool hasRelation(const Entity& source, const Entity& target)
+		{
+			if (target.m_world != this || !hasEntity(target))
+				return false;
+
+			return relation<R>().has(source.m_id, target.m_id);
+		}
+
+		/**
+		* Remove the pair of a source Entity and a target Entity.
+		*
+		* @param source    Reference to the source Entity.
+		* @param target    Reference to the target Entity.
+		*/
+		template <class R>
+		void removeRelation(const Entity& source, const Entity& target)
+		{
+			if (target.m_world == this)
+				relation<R>().remove(source.m_id, target.m_id);
 		}
 
 		/**
@@ -291,7 +1573,11 @@ namespace divvy{
 		*/
 		void replaceEntity(Entity& entity, Entity& other)
 		{
-			m_entities.at(entity.m_id) = other;
+			m_entities.rebind(entity.m_id, other);
+
+			// Components have to point to the Entity that replaced the old one
+			for (auto it = m_registry.begin(); it != m_registry.end(); it++)
+				it->second->rebind(entity.m_id, other);
 		}
 
 		/**
@@ -303,35 +1589,25 @@ namespace divvy{
 		* @return          Reference to the Component assigned.
 		*/
 		template <class T, class ... Args, typename = is_valid_component<T>>
-		T& addComponent(Entity& entity, Args&& ... args)
+		component_reference<T> addComponent(Entity& entity, Args&& ... args)
 		{
-			if (!hasEntity(entity))
-				throw std::runtime_error("Entity non-existent - call Entity.reset() beforehand");
-
-			if (!has<T>())
-				throw std::runtime_error("Component not registered - call World.add<T>() beforehand");
+			DIVVY_CHECK(hasEntity(entity), "Entity non-existent - call Entity.reset() beforehand");
+			DIVVY_CHECK(has<T>(), "Component not registered - call World.add<T>() beforehand");
 
 			auto& type = typeid(T);
+			auto& found = *pool<T>();
 
 			// Add to ComponentRegistry if not existing
-			if (!m_registry.at(type)->has(entity.m_id))
+			if (!found.has(entity.m_id))
 			{
-				m_registry.at(type)->add(entity.m_id);
-				m_registry.at(type)->at(entity.m_id).clone(T(std::forward<Args>(args)...));
-				m_registry.at(type)->at(entity.m_id).m_entity = &entity;
-
-#ifdef DIVVY_DEBUG
-				std::cout << "-- Added Component " << type.name() << " to " << entity << std::endl;
-#endif
+				found.emplace(entity.m_id, entity, std::forward<Args>(args)...);
+				found.churn().added(m_stats.tick);
+				DIVVY_LOG(Debug, "Added Component", type.name(), entity.m_id);
 			}
-#ifdef DIVVY_DEBUG
 			else
-			{
-				std::cerr << "-- WARNING: Component " << type.name() << " already present on " << entity << std::endl;
-			}
-#endif
+				DIVVY_LOG(Warning, "Component already present", type.name(), entity.m_id);
 
-			return static_cast<T&>(m_registry.at(type)->at(entity.m_id));
+			return found.get(entity.m_id);
 		}
 
 		/**
@@ -342,15 +1618,45 @@ namespace divvy{
 		* @return          Reference to the Component retrieved.
 		*/
 		template <class T, typename = is_valid_component<T>>
-		T& getComponent(const Entity& entity)
+		component_reference<T> getComponent(const Entity& entity)
 		{
-			if (!hasEntity(entity))
-				throw std::runtime_error("Entity non-existent - call hasEntity() beforehand");
+			DIVVY_CHECK(hasEntity(entity), "Entity non-existent - call hasEntity() beforehand");
+			DIVVY_CHECK(hasComponent<T>(entity), "Component non-existent - call hasComponent() beforehand");
 
-			if (!hasComponent<T>(entity))
-				throw std::runtime_error("Component non-existent - call hasComponent() beforehand");
+			return pool<T>()->get(entity.m_id);
+		}
+
+		/**
+		* Retreive an Entity's Component for reading only.
+		*
+		* @param entity    Reference to the target Entity.
+		*
+		* @return          Constant reference to the Component retrieved.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		const T& readComponent(const Entity& entity)
+		{
+			DIVVY_CHECK(hasEntity(entity), "Entity non-existent - call hasEntity() beforehand");
+			DIVVY_CHECK(hasComponent<T>(entity), "Component non-existent - call hasComponent() beforehand");
+
+			return static_cast<const pool_type<T>&>(*pool<T>()).get(entity.m_id);
+		}
+
+		/**
+		* Retreive an Entity's Component with the intent of modifying it.
+		* Shared Components are copied first if other Entities share the same value.
+		*
+		* @param entity    Reference to the target Entity.
+		*
+		* @return          Reference to the Component retrieved.
+		*/
+		template <class T, typename = is_valid_component<T>>
+		T& mutateComponent(const Entity& entity)
+		{
+			DIVVY_CHECK(hasEntity(entity), "Entity non-existent - call hasEntity() beforehand");
+			DIVVY_CHECK(hasComponent<T>(entity), "Component non-existent - call hasComponent() beforehand");
 
-			return static_cast<T&>(m_registry.at(typeid(T))->at(entity.m_id));
+			return pool<T>()->mutate(entity.m_id);
 		}
 
 		/**
@@ -365,11 +1671,12 @@ namespace divvy{
 
 			try
 			{
-#ifdef DIVVY_DEBUG
 				if (!m_registry.at(type)->has(entity.m_id))
-					std::cerr << "-- WARNING: Component " << type.name() << " already absent on " << entity << std::endl;
-#endif
+					DIVVY_LOG(Warning, "Component already absent", type.name(), entity.m_id);
+				else
+					m_registry.at(type)->churn().removed(m_stats.tick);
 				m_registry.at(type)->remove(entity.m_id);
+				m_registry.at(type)->setEnabled(entity.m_id, true);
 			}
 			catch (std::out_of_range e)
 			{
@@ -378,6 +1685,18 @@ namespace divvy{
 		}
 
 	private:
+		/**
+		* Find the pool of a Component type in constant time.
+		*
+		* @return          Pointer to the pool, or nullptr if the type isn't registered.
+		*/
+		template <class T>
+		inline pool_type<T>* pool() const
+		{
+			size_t id = typeID<T>();
+			return id < m_pools.size() ? static_cast<pool_type<T>*>(m_pools[id]) : nullptr;
+		}
+
 		/**
 		* These are the essential typedefs that describe what a registry and pool are and
 		* how to access their elements. Take note of the types used.
@@ -388,21 +1707,89 @@ namespace divvy{
 		/// The local registry of Components types and the Entites that use them.
 		ComponentRegistry m_registry;
 
-		/// Collection of Entities created in this World
-		std::vector<std::reference_wrapper<Entity>> m_entities;
+		/// The pools of the registry, indexed by the typeID of their Component type
+		std::vector<BaseComponentPool*> m_pools;
+
+		/// Order in which pools and systems are updated
+		Pipeline m_pipeline;
+
+		/// Lifecycle statistics of the current tick
+		TickStats m_stats;
+
+		/// Lifecycle statistics of the previous tick
+		TickStats m_lastStats;
+
+		/// Statistics of the latest ticks, if sampled
+		std::unique_ptr<StatsHistory> m_history;
+
+		/// Whether a frame of several updates was begun
+		bool m_framing = false;
+
+		/// Number of frames kept for rollback, 0 when disabled
+		size_t m_rollback = 0;
+
+		/// Number of frames currently available to restore
+		size_t m_kept = 0;
+
+		/// Number of the next frame saved
+		size_t m_frame = 0;
+
+		/// Previous values of the interpolated Component types
+		std::map<std::type_index, std::unique_ptr<BaseHistory>> m_histories;
+
+		/// Parent/child links between Entities
+		Hierarchy m_hierarchy;
 
 		/**
-		* An ordered queue in which Entities were deleted in.
-		* Serves the purpose of filling in gaps in memory where Entities were
-		* previously deleted.
+		* The slots recycled from a prefab.
 		*/
-		std::set<int> m_open;
+		struct Prefab
+		{
+			/// Slots of removed recycled Entities, kept warm for the prefab
+			std::vector<size_t> warm;
+
+			/// Living Entities recycled from the prefab
+			std::vector<size_t> children;
+		};
+
+		/// The prefab that every recycled Entity was created from
+		std::vector<size_t> m_origin;
 
-		/// Current capacity of possible Entities that could exist in the World.
-		size_t m_capacity = 0;
+		/// Position of every recycled Entity within its prefab's children
+		std::vector<size_t> m_sibling;
 
-		/// Count of Entities currently existing in the World.
-		size_t m_count = 0;
+		/// Recycled slots of every prefab, indexed by the EntityID of the prefab
+		std::vector<Prefab> m_prefabs;
+
+		/// Record of the disabled Entities
+		std::vector<bool> m_disabled;
+
+		/// Secondary indexes over Component values, by Component type
+		std::map<std::type_index, std::vector<std::unique_ptr<ChangeListener>>> m_indexes;
+
+		/// Spatial index over the designated position Component
+		std::unique_ptr<BaseSpatialIndex> m_spatial;
+
+		/// The designated position Component type
+		const std::type_info* m_spatialType = nullptr;
+
+		/// Buffer receiving the results of spatial queries
+		std::vector<size_t> m_found;
+
+		/// Relation pairs between Entities, indexed by the typeID of the relation
+		std::vector<std::unique_ptr<RelationIndex>> m_relations;
+
+		/// The relation indexes in use, to visit without going through every typeID
+		std::vector<RelationIndex*> m_relationKinds;
+
+		/// Event queues, indexed by the typeID of the event
+		std::vector<std::unique_ptr<BaseEventQueue>> m_events;
+
+		/// World-global singletons, indexed by typeID
+		std::vector<std::unique_ptr<BaseSingleton>> m_singletons;
+
+		/// Slots of the Entities created in this World, indexed by EntityID
+		EntityTable m_entities;
 
 		friend class Entity;
 	};
@@ -421,13 +1808,13 @@ namespace divvy{
 	* Without further ado...
 	*/
 
-	Entity::Entity(World& world)
+	inline Entity::Entity(World& world)
 		: m_world(&world),
 		m_id(world.addEntity(*this))
 	{
 	}
 
-	Entity::Entity(Entity&& other)
+	inline Entity::Entity(Entity&& other)
 	{
 		if (other.m_world)
 		{
@@ -439,37 +1826,32 @@ namespace divvy{
 		}
 	}
 
-	Entity::Entity(const Entity& other)
+	inline Entity::Entity(const Entity& other)
 		: m_world(other.m_world)
 	{
 		if (valid())
 		{
 			m_id = m_world->addEntity(*this, other);
 		}
-#ifdef DIVVY_DEBUG
 		else
-		{
-			std::cerr << "-- WARNING: Copying an uninitialized Entity" << std::endl;
-		}
-#endif
+			DIVVY_LOG(Warning, "Copying an uninitialized Entity", "", LogRecord::none());
 	}
 
-	Entity::Entity(const Entity& other, World& world)
+	inline Entity::Entity(const Entity& other, World& world)
 		: m_world(&world),
 		m_id(world.addEntity(*this, other))
 	{
 	}
 
-	Entity::~Entity()
+	inline Entity::~Entity()
 	{
 		reset();
 	}
 
 	template <class T, class ... Args, typename>
-	inline T& Entity::add(Args&& ... args)
+	inline component_reference<T> Entity::add(Args&& ... args)
 	{
-		if (!valid())
-			throw std::runtime_error("Uninitialized Entity, cannot add Component");
+		DIVVY_CHECK(valid(), "Uninitialized Entity, cannot add Component");
 
 		return m_world->addComponent<T>(*this, std::forward<Args>(args)...);
 	}
@@ -484,14 +1866,29 @@ namespace divvy{
 	}
 
 	template <class T, typename>
-	inline T& Entity::get()
+	inline component_reference<T> Entity::get()
 	{
-		if (!valid())
-			throw std::runtime_error("Uninitialized Entity, cannot get Component");
+		DIVVY_CHECK(valid(), "Uninitialized Entity, cannot get Component");
 
 		return m_world->getComponent<T>(*this);
 	}
 
+	template <class T, typename>
+	inline const T& Entity::read() const
+	{
+		DIVVY_CHECK(valid(), "Uninitialized Entity, cannot read Component");
+
+		return m_world->readComponent<T>(*this);
+	}
+
+	template <class T, typename>
+	inline T& Entity::mutate()
+	{
+		DIVVY_CHECK(valid(), "Uninitialized Entity, cannot mutate Component");
+
+		return m_world->mutateComponent<T>(*this);
+	}
+
 	template <class T, typename>
 	inline void Entity::remove()
 	{
@@ -501,6 +1898,94 @@ namespace divvy{
 		m_world->removeComponent<T>(*this);
 	}
 
+	inline void Entity::setParent(Entity& parent)
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot set parent");
+
+		m_world->setParent(*this, parent);
+	}
+
+	inline void Entity::removeParent()
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot remove parent");
+
+		m_world->m_hierarchy.detach(m_id);
+	}
+
+	inline Entity* Entity::parent()
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot get parent");
+
+		return m_world->getParent(*this);
+	}
+
+	template <class R>
+	inline void Entity::relate(const Entity& target)
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot relate");
+
+		m_world->addRelation<R>(*this, target);
+	}
+
+	template <class R>
+	inline bool Entity::related(const Entity& target)
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot check relation");
+
+		return m_world->hasRelation<R>(*this, target);
+	}
+
+	template <class R>
+	inline void Entity::unrelate(const Entity& target)
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot unrelate");
+
+		m_world->removeRelation<R>(*this, target);
+	}
+
+	inline void Entity::setEnabled(bool enabled)
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot enable");
+
+		m_world->setEntityEnabled(*this, enabled);
+	}
+
+	inline bool Entity::enabled() const
+	{
+		return valid() && m_world->isEnabled(m_id);
+	}
+
+	template <class T, typename>
+	inline void Entity::setEnabled(bool enabled)
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot enable Component");
+
+		m_world->setComponentEnabled<T>(*this, enabled);
+	}
+
+	template <class T, typename>
+	inline bool Entity::enabled()
+	{
+		if (!valid())
+			throw std::runtime_error("Uninitialized Entity, cannot check Component");
+
+		return m_world->isComponentEnabled<T>(*this);
+	}
+
+	inline void Entity::resetTree()
+	{
+		if (valid())
+			m_world->removeTree(*this);
+	}
+
 	inline void Entity::reset()
 	{
 		if (valid())
@@ -539,12 +2024,8 @@ namespace divvy{
 		{
 			m_id = m_world->addEntity(*this, other);
 		}
-#ifdef DIVVY_DEBUG
 		else
-		{
-			std::cerr << "-- WARNING: Resetting to a copy of an uninitialized Entity" << std::endl;
-		}
-#endif
+			DIVVY_LOG(Warning, "Resetting to a copy of an uninitialized Entity", "", LogRecord::none());
 	}
 
 	inline void Entity::reset(const Entity& other, World& world)
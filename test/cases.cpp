@@ -1,10 +1,19 @@
 #ifndef DIVVYTEST_HPP
 #define DIVVYTEST_HPP
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
 #include "catch.hpp"
 
 #define DIVVY_DEBUG
 #include "divvy.hpp"
+#include "divvy/Kernels.hpp"
+#include "divvy/ShardedWorld.hpp"
 using namespace divvy;
 
 
@@ -52,13 +61,16 @@ public:
 		return *this;
 	}
 
-	int getX() { return m_x; }
-	int getY() { return m_y; }
+	int getX() const { return m_x; }
+	int getY() const { return m_y; }
 
 private:
 	int m_x = 0, m_y = 0;
 };
 
+namespace divvy { template <> struct is_relocatable<Transform> : std::true_type {}; }
+namespace divvy { template <> struct is_byte_hashable<Transform> : std::true_type {}; }
+
 
 //=============================[ Component Example #2 ]==================================
 
@@ -88,13 +100,107 @@ public:
 		return *this;
 	}
 
-	const std::string& getName() { return m_name; }
+	const std::string& getName() const { return m_name; }
+
+	uint64_t hash() const { return hash::bytes(m_name.data(), m_name.size()); }
 
 private:
 	std::string m_name;
 };
 
 
+//================================[ Tag Example ]========================================
+
+
+struct Enemy {};
+
+
+//===============================[ Shared Example ]======================================
+
+
+struct Profile : public SharedComponent
+{
+	Profile() {}
+
+	Profile(int aggression) : aggression(aggression) {}
+
+	bool operator==(const Profile& other) const { return aggression == other.aggression; }
+
+	uint64_t hash() const { return static_cast<uint64_t>(aggression); }
+
+	int aggression = 0;
+};
+
+
+//=================================[ Pipeline Example ]==================================
+
+
+std::string& trace()
+{
+	static std::string steps;
+	return steps;
+}
+
+struct Physics : public Component
+{
+	virtual void update() { trace() += 'P'; }
+	virtual void clone(const Component&) {}
+};
+
+struct Render : public Component
+{
+	virtual void update() { trace() += 'R'; }
+	virtual void clone(const Component&) {}
+};
+
+
+//===================================[ Batch Example ]===================================
+
+
+struct Particle : public Component
+{
+	static void updateBatch(Particle* begin, Particle* end)
+	{
+		batches().push_back(end - begin);
+
+		for (Particle* it = begin; it != end; it++)
+			it->age++;
+	}
+
+	static std::vector<long>& batches()
+	{
+		static std::vector<long> sizes;
+		return sizes;
+	}
+
+	virtual void update() { age = -1; }
+	virtual void clone(const Component& other) { age = cast<Particle>(other).age; }
+
+	int age = 0;
+};
+
+
+struct Spark : public Particle
+{
+	virtual void clone(const Component& other) { age = cast<Spark>(other).age; }
+
+	float heat = 1;     // Stepping over a Spark array as Particles would be undefined
+};
+
+
+//==================================[ Logging Example ]==================================
+
+
+/**
+* Installs a log sink for a scope, going back to the default sink even when a test fails.
+*/
+struct SinkGuard
+{
+	SinkGuard(LogSink* sink) { setLogSink(sink); }
+	~SinkGuard() { setLogSink(&defaultSink()); }
+};
+
+
 //================================[ Test Cases ]=========================================
 
 
@@ -219,8 +325,8 @@ TEST_CASE("Entity can get Components", "[entity][component]")
 		entity.add<Transform>(1, 2);
 
 		REQUIRE(entity.has<Transform>());
-		REQUIRE(entity.get<Transform>().getX() == 1);
-		REQUIRE(entity.get<Transform>().getY() == 2);
+		REQUIRE(entity.read<Transform>().getX() == 1);
+		REQUIRE(entity.read<Transform>().getY() == 2);
 	}
 }
 
@@ -275,8 +381,8 @@ TEST_CASE("Entity is copyable", "[entity]")
 		Entity copy(entity);
 
 		REQUIRE(copy.valid());
-		REQUIRE(copy.get<Transform>().getX() == 1);
-		REQUIRE(copy.get<Transform>().getY() == 2);
+		REQUIRE(copy.read<Transform>().getX() == 1);
+		REQUIRE(copy.read<Transform>().getY() == 2);
 	}
 	
 	SECTION("copying using the equals operator")
@@ -284,8 +390,8 @@ TEST_CASE("Entity is copyable", "[entity]")
 		Entity copy = entity;
 
 		REQUIRE(copy.valid());
-		REQUIRE(copy.get<Transform>().getX() == 1);
-		REQUIRE(copy.get<Transform>().getY() == 2);
+		REQUIRE(copy.read<Transform>().getX() == 1);
+		REQUIRE(copy.read<Transform>().getY() == 2);
 	}
 }
 
@@ -309,8 +415,8 @@ TEST_CASE("Entity is copyable across Worlds", "[entity][world]")
 	REQUIRE(copy.has<Transform>());
 	REQUIRE_FALSE(copy.has<Nametag>());
 
-	REQUIRE(copy.get<Transform>().getX() == 1);
-	REQUIRE(copy.get<Transform>().getY() == 2);
+	REQUIRE(copy.read<Transform>().getX() == 1);
+	REQUIRE(copy.read<Transform>().getY() == 2);
 }
 
 
@@ -329,8 +435,8 @@ TEST_CASE("Entity is movable", "[entity]")
 		REQUIRE_FALSE(entity.valid());
 
 		REQUIRE(copy.valid());
-		REQUIRE(copy.get<Transform>().getX() == 1);
-		REQUIRE(copy.get<Transform>().getY() == 2);
+		REQUIRE(copy.read<Transform>().getX() == 1);
+		REQUIRE(copy.read<Transform>().getY() == 2);
 	}
 
 	SECTION("copying using the equals operator")
@@ -340,8 +446,8 @@ TEST_CASE("Entity is movable", "[entity]")
 		REQUIRE_FALSE(entity.valid());
 
 		REQUIRE(copy.valid());
-		REQUIRE(copy.get<Transform>().getX() == 1);
-		REQUIRE(copy.get<Transform>().getY() == 2);
+		REQUIRE(copy.read<Transform>().getX() == 1);
+		REQUIRE(copy.read<Transform>().getY() == 2);
 	}
 }
 
@@ -379,8 +485,8 @@ TEST_CASE("Entity can reset", "[entity][world]")
 		REQUIRE(copy.valid());
 		REQUIRE(copy.has<Transform>());
 
-		REQUIRE(copy.get<Transform>().getX() == 1);
-		REQUIRE(copy.get<Transform>().getY() == 2);
+		REQUIRE(copy.read<Transform>().getX() == 1);
+		REQUIRE(copy.read<Transform>().getY() == 2);
 	}
 
 	SECTION("resetting by copying between Worlds")
@@ -396,7 +502,7 @@ TEST_CASE("Entity can reset", "[entity][world]")
 		REQUIRE(copy.has<Nametag>());
 		REQUIRE_FALSE(copy.has<Transform>());
 
-		REQUIRE(copy.get<Nametag>().getName().compare("Divvy") == 0);
+		REQUIRE(copy.read<Nametag>().getName().compare("Divvy") == 0);
 	}
 }
 
@@ -410,13 +516,1714 @@ TEST_CASE("World can update Entities", "[world][entity]")
 	entity.add<Transform>(1, 2);
 
 	REQUIRE(entity.has<Transform>());
-	REQUIRE(entity.get<Transform>().getX() == 1);
-	REQUIRE(entity.get<Transform>().getY() == 2);
+	REQUIRE(entity.read<Transform>().getX() == 1);
+	REQUIRE(entity.read<Transform>().getY() == 2);
 
 	world.update();
 
-	REQUIRE(entity.get<Transform>().getX() == 2);
-	REQUIRE(entity.get<Transform>().getY() == 3);
+	REQUIRE(entity.read<Transform>().getX() == 2);
+	REQUIRE(entity.read<Transform>().getY() == 3);
+}
+
+
+TEST_CASE("Tags are stored as bits", "[entity][tag]")
+{
+	World world;
+	Entity entity(world);
+
+	REQUIRE(is_tag<Enemy>::value);
+	REQUIRE_FALSE(is_tag<Transform>::value);
+
+	world.add<Enemy>();
+	world.add<Transform>();
+	entity.add<Transform>(1, 2);
+
+	SECTION("adding and removing a tag")
+	{
+		REQUIRE_FALSE(entity.has<Enemy>());
+
+		entity.add<Enemy>();
+		REQUIRE(entity.has<Enemy>());
+
+		entity.remove<Enemy>();
+		REQUIRE_FALSE(entity.has<Enemy>());
+	}
+
+	SECTION("copying a tagged Entity")
+	{
+		entity.add<Enemy>();
+		Entity copy(entity);
+
+		REQUIRE(copy.has<Enemy>());
+		REQUIRE(copy.read<Transform>().getX() == 1);
+	}
+
+	SECTION("updating a World with tags")
+	{
+		entity.add<Enemy>();
+		world.update();
+
+		REQUIRE(entity.has<Enemy>());
+		REQUIRE(entity.read<Transform>().getX() == 2);
+	}
+}
+
+
+TEST_CASE("World holds singletons", "[world][singleton]")
+{
+	World world;
+
+	struct Clock
+	{
+		Clock() {}
+		Clock(int ticks) : ticks(ticks) {}
+		int ticks = 0;
+	};
+
+	SECTION("creating a singleton on access")
+	{
+		REQUIRE_FALSE(world.hasSingleton<Clock>());
+
+		world.singleton<Clock>().ticks++;
+		REQUIRE(world.hasSingleton<Clock>());
+		REQUIRE(world.singleton<Clock>().ticks == 1);
+	}
+
+	SECTION("setting and removing a singleton")
+	{
+		world.setSingleton<Clock>(5);
+		REQUIRE(world.singleton<Clock>().ticks == 5);
+
+		world.removeSingleton<Clock>();
+		REQUIRE_FALSE(world.hasSingleton<Clock>());
+	}
+
+	SECTION("clearing singletons")
+	{
+		world.singleton<Clock>();
+		world.clear();
+		REQUIRE_FALSE(world.hasSingleton<Clock>());
+	}
+}
+
+
+TEST_CASE("Shared Components are deduplicated", "[entity][shared]")
+{
+	World world;
+	world.add<Profile>();
+
+	Entity a(world), b(world), c(world);
+
+	a.add<Profile>(5);
+	b.add<Profile>(5);
+	c.add<Profile>(7);
+
+	SECTION("sharing equal values")
+	{
+		REQUIRE(&a.get<Profile>() == &b.get<Profile>());
+		REQUIRE(&a.get<Profile>() != &c.get<Profile>());
+	}
+
+	SECTION("copying an Entity shares its value")
+	{
+		Entity copy(a);
+		REQUIRE(&copy.get<Profile>() == &a.get<Profile>());
+	}
+
+	SECTION("copying on mutation")
+	{
+		b.mutate<Profile>().aggression = 9;
+
+		REQUIRE(a.read<Profile>().aggression == 5);
+		REQUIRE(b.read<Profile>().aggression == 9);
+
+		c.mutate<Profile>().aggression = 8;
+		REQUIRE(c.read<Profile>().aggression == 8);
+
+		Entity d(world);
+		d.add<Profile>(8);
+		REQUIRE(&d.get<Profile>() == &c.get<Profile>());
+		REQUIRE(&d.get<Profile>() != &a.get<Profile>());
+	}
+
+	SECTION("grouping Entities by value")
+	{
+		int fives = 0, sevens = 0;
+
+		world.group<Profile>([&](const Profile& profile, Entity& entity)
+		{
+			REQUIRE(&entity.get<Profile>() == &profile);
+
+			if (profile.aggression == 5)
+				fives++;
+			else if (profile.aggression == 7)
+				sevens++;
+		});
+
+		REQUIRE(fives == 2);
+		REQUIRE(sevens == 1);
+	}
+
+	SECTION("removing a shared Component")
+	{
+		a.remove<Profile>();
+
+		REQUIRE_FALSE(a.has<Profile>());
+		REQUIRE(b.read<Profile>().aggression == 5);
+	}
+}
+
+
+TEST_CASE("Entities form a hierarchy", "[entity][hierarchy]")
+{
+	World world;
+	world.add<Transform>();
+
+	Entity root(world), child(world), grandchild(world), other(world);
+
+	root.add<Transform>(1, 1);
+	child.add<Transform>(2, 2);
+	grandchild.add<Transform>(3, 3);
+
+	grandchild.setParent(child);
+	child.setParent(root);
+
+	SECTION("retrieving parents")
+	{
+		REQUIRE(root.parent() == nullptr);
+		REQUIRE(child.parent() == &root);
+		REQUIRE(grandchild.parent() == &child);
+	}
+
+	SECTION("rejecting cycles")
+	{
+		REQUIRE_THROWS_AS(root.setParent(grandchild), std::runtime_error);
+	}
+
+	SECTION("traversing parents before children")
+	{
+		std::vector<Entity*> visited;
+		world.traverse([&](Entity& entity) { visited.push_back(&entity); });
+
+		REQUIRE(visited.size() == 3);
+		REQUIRE(visited[0] == &root);
+		REQUIRE(visited[1] == &child);
+		REQUIRE(visited[2] == &grandchild);
+	}
+
+	SECTION("propagating Components")
+	{
+		world.propagate<Transform>([](Transform& parent, Transform& child)
+		{
+			child.setX(parent.getX() + child.getX());
+		});
+
+		REQUIRE(child.read<Transform>().getX() == 3);
+		REQUIRE(grandchild.read<Transform>().getX() == 6);
+	}
+
+	SECTION("detaching from a parent")
+	{
+		child.removeParent();
+
+		REQUIRE(child.parent() == nullptr);
+		REQUIRE(grandchild.parent() == &child);
+	}
+
+	SECTION("removing a subtree")
+	{
+		child.resetTree();
+
+		REQUIRE(root.valid());
+		REQUIRE(other.valid());
+		REQUIRE_FALSE(child.valid());
+		REQUIRE_FALSE(grandchild.valid());
+	}
+}
+
+
+TEST_CASE("Entities can relate to each other", "[entity][relation]")
+{
+	struct Targets {};
+	struct OwnedBy {};
+
+	World world;
+	Entity hero(world), goomba(world), koopa(world);
+
+	goomba.relate<Targets>(hero);
+	koopa.relate<Targets>(hero);
+	goomba.relate<OwnedBy>(koopa);
+
+	SECTION("checking relations")
+	{
+		REQUIRE(goomba.related<Targets>(hero));
+		REQUIRE_FALSE(goomba.related<OwnedBy>(hero));
+		REQUIRE_FALSE(hero.related<Targets>(goomba));
+	}
+
+	SECTION("looking up targets and sources")
+	{
+		std::vector<Entity*> found;
+
+		world.sources<Targets>(hero, [&](Entity& source) { found.push_back(&source); });
+		REQUIRE(found.size() == 2);
+
+		found.clear();
+		world.targets<OwnedBy>(goomba, [&](Entity& target) { found.push_back(&target); });
+		REQUIRE(found.size() == 1);
+		REQUIRE(found[0] == &koopa);
+	}
+
+	SECTION("removing a relation")
+	{
+		goomba.unrelate<Targets>(hero);
+
+		int count = 0;
+		world.sources<Targets>(hero, [&](Entity&) { count++; });
+
+		REQUIRE(count == 1);
+		REQUIRE_FALSE(goomba.related<Targets>(hero));
+	}
+
+	SECTION("relations survive moving an Entity")
+	{
+		Entity moved(std::move(koopa));
+
+		std::vector<Entity*> found;
+		world.targets<OwnedBy>(goomba, [&](Entity& target) { found.push_back(&target); });
+
+		REQUIRE(found.size() == 1);
+		REQUIRE(found[0] == &moved);
+	}
+
+	SECTION("removing an Entity removes its relations")
+	{
+		koopa.reset();
+
+		int count = 0;
+		world.sources<Targets>(hero, [&](Entity&) { count++; });
+		world.targets<OwnedBy>(goomba, [&](Entity&) { count++; });
+
+		REQUIRE(count == 1);
+	}
+}
+
+
+TEST_CASE("Component values can be indexed", "[world][index]")
+{
+	World world;
+	world.add<Nametag>();
+	world.add<Transform>();
+
+	Entity mario(world), bowser(world), goomba(world);
+
+	mario.add<Nametag>("Mario");
+	bowser.add<Nametag>("Bowser");
+	mario.add<Transform>(1, 0);
+	bowser.add<Transform>(5, 0);
+	goomba.add<Transform>(3, 0);
+
+	auto& byName = world.index<HashIndex<Nametag, std::string>>([](const Nametag& tag) { return tag.getName(); });
+	auto& byX = world.index<OrderedIndex<Transform, int>>([](const Transform& t) { return t.getX(); });
+
+	SECTION("finding by equality")
+	{
+		std::vector<Entity*> found;
+		world.find(byName, "Bowser", [&](Entity& entity) { found.push_back(&entity); });
+
+		REQUIRE(found.size() == 1);
+		REQUIRE(found[0] == &bowser);
+		REQUIRE(byName.count("Luigi") == 0);
+	}
+
+	SECTION("finding by range")
+	{
+		std::vector<Entity*> found;
+		world.range(byX, 2, 5, [&](Entity& entity) { found.push_back(&entity); });
+
+		REQUIRE(found.size() == 2);
+		REQUIRE(found[0] == &goomba);
+		REQUIRE(found[1] == &bowser);
+	}
+
+	SECTION("following additions, mutations, and removals")
+	{
+		goomba.add<Nametag>("Bowser");
+		REQUIRE(byName.count("Bowser") == 2);
+
+		bowser.mutate<Nametag>().setName("Koopa");
+		REQUIRE(byName.count("Bowser") == 1);
+		REQUIRE(byName.count("Koopa") == 1);
+
+		goomba.remove<Nametag>();
+		REQUIRE(byName.count("Bowser") == 0);
+
+		mario.reset();
+		REQUIRE(byName.count("Mario") == 0);
+	}
+
+	SECTION("following untracked writes")
+	{
+		world.update();     // Every Transform moves one to the right
+		REQUIRE(byX.count(1) == 0);
+		REQUIRE(byX.count(6) == 1);
+
+		goomba.get<Transform>().setX(9);
+		REQUIRE(byX.count(4) == 0);
+		REQUIRE(byX.count(9) == 1);
+	}
+}
+
+
+TEST_CASE("Indexes only revisit the Components handed out for writing", "[world][index]")
+{
+	struct Team : public Component
+	{
+		Team() {}
+
+		Team(int id) : id(id) {}
+
+		virtual void clone(const Component& other) { id = cast<Team>(other).id; }
+
+		int id = 0;
+	};
+
+	World world;
+	world.add<Team>();
+
+	std::vector<Entity> entities(100);
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		entities[i].reset(world);
+		entities[i].add<Team>(static_cast<int>(i % 4));
+	}
+
+	size_t extracted = 0;
+	auto& byTeam = world.index<HashIndex<Team, int>>([&](const Team& team) { extracted++; return team.id; });
+
+	REQUIRE(byTeam.count(1) == 25);
+	REQUIRE(extracted == 100);
+
+	SECTION("reads and updates of data only are no change")
+	{
+		world.update();
+		REQUIRE(entities[5].read<Team>().id == 1);
+		REQUIRE(world.accessor<Team>().read(entities[6]).id == 2);
+
+		REQUIRE(byTeam.count(1) == 25);
+		REQUIRE(extracted == 100);
+	}
+
+	SECTION("writes are revisited per Entity")
+	{
+		entities[5].get<Team>().id = 2;
+		world.accessor<Team>()[entities[9]].id = 3;
+
+		REQUIRE(byTeam.count(1) == 23);
+		REQUIRE(byTeam.count(3) == 26);
+		REQUIRE(extracted == 102);
+	}
+}
+
+
+TEST_CASE("World can query positions", "[world][spatial]")
+{
+	World world;
+	world.add<Transform>();
+
+	Entity near(world), far(world), unplaced(world);
+
+	near.add<Transform>(1, 1);
+	far.add<Transform>(20, 20);
+
+	world.spatial<SpatialGrid<Transform>>(4.0f, [](const Transform& t)
+	{
+		return Point(static_cast<float>(t.getX()), static_cast<float>(t.getY()));
+	});
+
+	SECTION("querying a radius")
+	{
+		std::vector<Entity*> found;
+		world.queryRadius(Point(0, 0), 2.0f, [&](Entity& entity) { found.push_back(&entity); });
+
+		REQUIRE(found.size() == 1);
+		REQUIRE(found[0] == &near);
+	}
+
+	SECTION("querying a box")
+	{
+		int count = 0;
+		world.queryAABB(Point(-100, -100), Point(100, 100), [&](Entity&) { count++; });
+
+		REQUIRE(count == 2);
+	}
+
+	SECTION("following mutations and removals")
+	{
+		far.mutate<Transform>().setX(2).setY(0);
+		unplaced.add<Transform>(0, 1);
+		near.remove<Transform>();
+
+		std::vector<Entity*> found;
+		world.queryRadius(Point(0, 0), 2.0f, [&](Entity& entity) { found.push_back(&entity); });
+
+		REQUIRE(found.size() == 2);
+	}
+
+	SECTION("following untracked writes")
+	{
+		world.update();     // Both move to (2, 2) and (21, 21)
+		far.get<Transform>().setX(-1).setY(-1);
+
+		std::vector<Entity*> found;
+		world.queryRadius(Point(0, 0), 2.0f, [&](Entity& entity) { found.push_back(&entity); });
+
+		REQUIRE(found.size() == 1);
+		REQUIRE(found[0] == &far);
+	}
+
+	SECTION("querying huge and non-finite boxes")
+	{
+		float infinity = std::numeric_limits<float>::infinity();
+		int count = 0;
+
+		world.queryAABB(Point(-1e30f, -1e30f), Point(1e30f, 1e30f), [&](Entity&) { count++; });
+		world.queryAABB(Point(-infinity, -infinity), Point(infinity, infinity), [&](Entity&) { count++; });
+		world.queryRadius(Point(0, 0), std::numeric_limits<float>::quiet_NaN(), [&](Entity&) { count++; });
+
+		REQUIRE(count == 4);
+	}
+}
+
+
+TEST_CASE("Spatial indexes only revisit the positions written", "[world][spatial]")
+{
+	struct Position : public Component
+	{
+		Position() {}
+
+		Position(float x, float y) : x(x), y(y) {}
+
+		virtual void clone(const Component& other) { x = cast<Position>(other).x; y = cast<Position>(other).y; }
+
+		float x = 0, y = 0;
+	};
+
+	World world;
+	world.add<Position>();
+	world.add<Transform>();
+
+	std::vector<Entity> entities(100);
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		entities[i].reset(world);
+		entities[i].add<Position>(static_cast<float>(i), 0.0f);
+		entities[i].add<Transform>();
+	}
+
+	size_t extracted = 0;
+	world.spatial<SpatialGrid<Position>>(4.0f, [&](const Position& p) { extracted++; return Point(p.x, p.y); });
+	world.system([&](World&) { entities[50].get<Position>().x = -10; });
+
+	std::vector<Entity*> found;
+	world.queryRadius(Point(-10, 0), 1.0f, [&](Entity& entity) { found.push_back(&entity); });
+
+	REQUIRE(found.empty());
+	REQUIRE(extracted == 100);
+
+	world.update();     // Only the system writes a position
+	world.queryRadius(Point(-10, 0), 1.0f, [&](Entity& entity) { found.push_back(&entity); });
+
+	REQUIRE(found.size() == 1);
+	REQUIRE(found[0] == &entities[50]);
+	REQUIRE(extracted == 101);
+}
+
+
+TEST_CASE("Entities and Components can be disabled", "[entity][world]")
+{
+	World world;
+	world.add<Transform>();
+
+	Entity entity(world);
+	entity.add<Transform>(1, 2);
+
+	SECTION("disabling an Entity")
+	{
+		entity.setEnabled(false);
+		REQUIRE_FALSE(entity.enabled());
+
+		world.update();
+		REQUIRE(entity.read<Transform>().getX() == 1);
+
+		entity.setEnabled(true);
+		world.update();
+		REQUIRE(entity.read<Transform>().getX() == 2);
+	}
+
+	SECTION("disabling a Component")
+	{
+		entity.setEnabled<Transform>(false);
+		REQUIRE(entity.has<Transform>());
+		REQUIRE_FALSE(entity.enabled<Transform>());
+
+		world.update();
+		REQUIRE(entity.read<Transform>().getX() == 1);
+	}
+
+	SECTION("views skip disabled Entities")
+	{
+		Entity child(world);
+		child.setParent(entity);
+		child.setEnabled(false);
+
+		int count = 0;
+		world.traverse([&](Entity&) { count++; });
+
+		REQUIRE(count == 1);
+	}
+
+	SECTION("removed Entities free their slot enabled")
+	{
+		entity.setEnabled(false);
+		entity.reset(world);
+
+		REQUIRE(entity.enabled());
+	}
+}
+
+
+TEST_CASE("Entities can be recycled from a prefab", "[world][entity]")
+{
+	World world;
+	world.add<Nametag>();
+	world.add<Transform>();
+
+	Entity prefab(world);
+	prefab.add<Nametag>("Bullet");
+	prefab.add<Transform>(1, 2);
+
+	Entity spare(world);
+
+	const Nametag* slot = nullptr;
+	size_t capacity = 0;
+
+	{
+		Entity bullet = world.recycle(prefab);
+
+		REQUIRE(bullet.valid());
+		REQUIRE(bullet.read<Nametag>().getName() == "Bullet");
+		REQUIRE(bullet.read<Transform>().getY() == 2);
+
+		bullet.get<Nametag>().setName("A bullet with a name long enough to allocate");
+		bullet.add<Transform>().setX(7);
+
+		slot = &bullet.get<Nametag>();
+		capacity = bullet.get<Nametag>().getName().capacity();
+	}
+
+	spare.reset(); // Opens a regular slot, which a non-recycled Entity would take first
+
+	Entity again = world.recycle(prefab);
+
+	REQUIRE(&again.get<Nametag>() == slot);
+	REQUIRE(again.read<Nametag>().getName() == "Bullet");
+	REQUIRE(again.read<Nametag>().getName().capacity() >= capacity);
+	REQUIRE(again.read<Transform>().getX() == 1);
+
+	SECTION("removing the prefab releases its warm slots")
+	{
+		again.reset();
+		prefab.reset();
+
+		Entity reused(world);
+		REQUIRE(reused.valid());
+		REQUIRE_FALSE(reused.has<Nametag>());
+	}
+
+	SECTION("removing the prefab orphans its recycled Entities")
+	{
+		Entity other = world.recycle(prefab);
+		EntityID id = again.id();
+
+		prefab.reset();
+		again.reset();                  // Its slot opens instead of staying warm
+
+		Entity reused(world);
+		REQUIRE(reused.id() == id);
+		REQUIRE(other.valid());
+	}
+}
+
+
+TEST_CASE("World queues events", "[world][event]")
+{
+	struct Damage
+	{
+		Damage(int amount) : amount(amount) {}
+		int amount;
+	};
+
+	World world;
+
+	int batches = 0, total = 0;
+
+	world.listen<Damage>([&](const std::vector<Damage>& events)
+	{
+		batches++;
+
+		for (size_t i = 0; i < events.size(); i++)
+			total += events[i].amount;
+	});
+
+	world.emit<Damage>(3);
+	world.emit<Damage>(4);
+
+	SECTION("events are readable on the next update")
+	{
+		REQUIRE(world.events<Damage>().empty());
+		REQUIRE(total == 0);
+
+		world.update();
+
+		REQUIRE(world.events<Damage>().size() == 2);
+		REQUIRE(batches == 1);
+		REQUIRE(total == 7);
+	}
+
+	SECTION("events last a single frame")
+	{
+		world.update();
+		world.update();
+
+		REQUIRE(world.events<Damage>().empty());
+		REQUIRE(batches == 1);
+	}
+}
+
+
+TEST_CASE("World updates in pipeline stages", "[world][pipeline]")
+{
+	trace().clear();
+
+	World world;
+	world.add<Render>(Stage::PostUpdate);
+	world.add<Physics>(Stage::PreUpdate);
+	world.system([](World&) { trace() += 'S'; });
+
+	Entity entity(world);
+	entity.add<Render>();
+	entity.add<Physics>();
+
+	SECTION("stages run in order regardless of registration")
+	{
+		world.update();
+		REQUIRE(trace() == "PSR");
+	}
+
+	SECTION("types can be moved to custom stages")
+	{
+		world.setStage<Physics>(Stage::Update + 1);
+		world.system([](World&) { trace() += 'C'; }, Stage::Update + 1);
+
+		world.update();
+		REQUIRE(trace() == "SPCR");
+	}
+
+	SECTION("removed types leave the pipeline")
+	{
+		world.remove<Physics>();
+
+		world.update();
+		REQUIRE(trace() == "SR");
+		REQUIRE_THROWS(world.setStage<Physics>(Stage::Update));
+	}
+
+	SECTION("systems can change the pipeline while it runs")
+	{
+		world.system([](World& w)
+		{
+			if (w.has<Transform>())
+				return;
+
+			w.add<Transform>();         // Registers a pool mid-update
+			w.remove<Render>();         // Removes a pool that has yet to run
+
+			for (int i = 0; i < 32; i++)
+				w.system([](World&) { trace() += 'A'; });
+		});
+
+		world.update();
+		REQUIRE(trace() == "PS");
+		REQUIRE(world.has<Transform>());
+
+		trace().clear();
+		world.update();
+		REQUIRE(trace() == "PS" + std::string(32, 'A'));
+	}
+}
+
+
+TEST_CASE("Runner steps the World at a fixed rate", "[world][runner]")
+{
+	trace().clear();
+
+	World world;
+	world.add<Physics>();
+	world.add<Render>(Stage::PostUpdate);
+	world.add<Transform>();
+	world.setRate(Stage::PostUpdate, Rate::Variable);
+	world.interpolate<Transform>();
+
+	Entity entity(world);
+	entity.add<Physics>();
+	entity.add<Render>();
+	entity.add<Transform>(0, 0);
+
+	Runner runner(world, 0.25, 3);
+
+	SECTION("elapsed time is consumed in fixed steps")
+	{
+		REQUIRE(runner.advance(0.625) == 2);
+		REQUIRE(trace() == "PPR");
+		REQUIRE(runner.alpha() == Approx(0.5));
+		REQUIRE(world.singleton<Clock>().time == Approx(0.5));
+
+		REQUIRE(runner.advance(0.125) == 1);
+		REQUIRE(trace() == "PPRPR");
+	}
+
+	SECTION("catching up is limited")
+	{
+		REQUIRE(runner.advance(10) == 3);
+		REQUIRE(runner.alpha() < 1);
+	}
+
+	SECTION("previous values trail by a fixed step")
+	{
+		runner.advance(0.5);
+
+		REQUIRE(entity.read<Transform>().getX() == 2);
+		REQUIRE(world.previous<Transform>(entity).getX() == 1);
+
+		runner.advance(0.1);
+		REQUIRE(world.previous<Transform>(entity).getX() == 1);
+	}
+
+	SECTION("a frame is a single tick of events and statistics")
+	{
+		struct Ping {};
+		std::vector<size_t> seen;
+
+		world.system([&](World& w) { seen.push_back(w.events<Ping>().size()); });
+		world.system([](World& w) { w.emit<Ping>(); }, Stage::PostUpdate);
+
+		runner.advance(0.5);
+		size_t tick = world.stats().tick;
+
+		runner.advance(0.5);
+		runner.advance(0.5);
+
+		REQUIRE(world.stats().tick == tick + 2);
+		REQUIRE(seen == std::vector<size_t>({0, 0, 1, 1, 1, 1}));
+	}
+
+	REQUIRE_THROWS(Runner(world, 0));
+}
+
+
+TEST_CASE("Pools update contiguous runs in batches", "[world][batch]")
+{
+	Particle::batches().clear();
+
+	World world;
+	world.add<Particle>();
+
+	Entity a(world), b(world), c(world), d(world);
+	a.add<Particle>();
+	b.add<Particle>();
+	d.add<Particle>();
+
+	world.update();
+
+	REQUIRE(Particle::batches() == std::vector<long>({2, 1}));
+	REQUIRE(a.get<Particle>().age == 1);
+	REQUIRE(d.get<Particle>().age == 1);
+
+	SECTION("disabled Components split runs")
+	{
+		Particle::batches().clear();
+		b.setEnabled<Particle>(false);
+		c.add<Particle>();
+
+		world.update();
+
+		REQUIRE(Particle::batches() == std::vector<long>({1, 2}));
+		REQUIRE(b.get<Particle>().age == 1);
+	}
+
+	SECTION("derived types don't inherit the batch update")
+	{
+		REQUIRE_FALSE(has_update_batch<Spark>::value);
+
+		world.add<Spark>();
+		a.add<Spark>();
+		Particle::batches().clear();
+
+		world.update();
+
+		REQUIRE(Particle::batches().size() == 2);
+		REQUIRE(a.get<Spark>().age == -1);
+	}
+}
+
+
+TEST_CASE("Pools are aligned and iterated in spans", "[world][span]")
+{
+	std::vector<std::unique_ptr<Entity>> entities;
+
+	World world;
+	world.add<Particle>();
+
+	for (int i = 0; i < 40; i++)
+	{
+		entities.emplace_back(new Entity(world));
+		entities.back()->add<Particle>();
+	}
+
+	size_t stride = ComponentPool<Particle>::stride();
+
+	SECTION("storage is aligned")
+	{
+		REQUIRE(reinterpret_cast<uintptr_t>(&entities[0]->get<Particle>()) % pool_alignment<Particle>::value == 0);
+		REQUIRE(reinterpret_cast<uintptr_t>(&entities[stride]->get<Particle>()) % pool_alignment<Particle>::value == 0);
+	}
+
+	SECTION("spans cover every active Component")
+	{
+		entities[10]->remove<Particle>();
+
+		size_t count = 0, spans = 0;
+
+		world.spans<Particle>([&](Particle* begin, Particle* end)
+		{
+			count += end - begin;
+			spans++;
+		});
+
+		REQUIRE(count == 39);
+		REQUIRE(spans == 2);
+	}
+
+	SECTION("chunks start on aligned boundaries")
+	{
+		bool first = true, aligned = true;
+		size_t count = 0;
+
+		world.spans<Particle>([&](Particle* begin, Particle* end)
+		{
+			if (!first && reinterpret_cast<uintptr_t>(begin) % pool_alignment<Particle>::value != 0)
+				aligned = false;
+
+			first = false;
+			count += end - begin;
+		}, 1);
+
+		REQUIRE(aligned);
+		REQUIRE(count == 40);
+	}
+}
+
+
+TEST_CASE("Kernels agree across instruction sets", "[simd]")
+{
+	const size_t count = 19;  // Leaves a remainder for every vector width
+
+	// Aligned to every vector width, and offset by one float for the unaligned paths
+	alignas(32) float x[count + 1], y[count + 1], velocity[count + 1];
+	alignas(32) float position[count + 1], low[count + 1], high[count + 1];
+
+	simd::Level levels[] = {simd::Level::Scalar, simd::Level::SSE2, simd::Level::AVX2};
+
+	for (size_t offset = 0; offset < 2; offset++)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			x[offset + i] = static_cast<float>(i);
+			y[offset + i] = static_cast<float>(i % 3);
+			velocity[offset + i] = static_cast<float>(i) * 0.5f - 4;
+		}
+
+		for (simd::Level level : levels)
+		{
+			simd::setLevel(level);
+			REQUIRE(simd::level() <= level);
+
+			std::copy(x + offset, x + offset + count, position + offset);
+			std::vector<size_t> visible;
+
+			simd::integrate(position + offset, velocity + offset, 2, count);
+			simd::clamp(position + offset, -5, 20, count);
+			simd::bounds(x + offset, velocity + offset, low + offset, high + offset, count);
+			simd::cull(x + offset, y + offset, 0, 0, 5, count, visible);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				float moved = x[offset + i] + velocity[offset + i] * 2;
+				REQUIRE(position[offset + i] == Approx(moved < -5 ? -5 : (moved > 20 ? 20 : moved)));
+				REQUIRE(low[offset + i] == Approx(x[offset + i] - velocity[offset + i]));
+				REQUIRE(high[offset + i] == Approx(x[offset + i] + velocity[offset + i]));
+			}
+
+			REQUIRE(visible == std::vector<size_t>({0, 1, 2, 3, 4}));
+
+			// Not a number stays so
+			std::fill(position, position + count + 1, std::numeric_limits<float>::quiet_NaN());
+			simd::clamp(position + offset, -5, 20, count);
+
+			for (size_t i = 0; i < count; i++)
+				REQUIRE(std::isnan(position[offset + i]));
+		}
+	}
+
+	simd::setLevel(simd::detect());
+}
+
+
+TEST_CASE("Kernels run over spans of Components", "[simd][world]")
+{
+	struct Particle : public Component
+	{
+		Particle() {}
+
+		Particle(float x, float vx) : x(x), vx(vx) {}
+
+		virtual void clone(const Component& other) { x = cast<Particle>(other).x; vx = cast<Particle>(other).vx; }
+
+		float x = 0, vx = 0;
+	};
+
+	World world;
+	world.add<Particle>();
+
+	std::vector<Entity> entities(37);
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		entities[i].reset(world);
+		entities[i].add<Particle>(static_cast<float>(i), 2.0f);
+	}
+
+	entities[10].remove<Particle>();   // Splits the Components into two spans
+
+	size_t spans = 0;
+
+	world.spans<Particle>([&](Particle* begin, Particle* end)
+	{
+		simd::Gather<Particle> span(begin, end);
+		REQUIRE(simd::aligned(32, {span(&Particle::x), span(&Particle::vx)}));
+
+		simd::integrate(span(&Particle::x), span(&Particle::vx), 0.5f, span.size());
+		span.scatter(&Particle::x);
+		spans++;
+	});
+
+	REQUIRE(spans == 2);
+
+	for (size_t i = 0; i < entities.size(); i++)
+		if (i != 10)
+			REQUIRE(entities[i].read<Particle>().x == Approx(static_cast<float>(i) + 1));
+
+	REQUIRE(entities[0].read<Particle>().vx == 2.0f);
+}
+
+
+TEST_CASE("Accessors retrieve Components directly", "[world][accessor]")
+{
+	World world, other;
+	world.add<Transform>();
+	world.add<Profile>();
+	world.add<Enemy>();
+
+	Entity entity(world), stranger(other);
+	entity.add<Transform>(4, 2);
+	entity.add<Profile>(7);
+
+	auto transforms = world.accessor<Transform>();
+	auto profiles = world.accessor<Profile>();
+
+	REQUIRE(transforms[entity].getX() == 4);
+	REQUIRE(profiles[entity].aggression == 7);
+
+	transforms[entity].setX(5);
+	REQUIRE(entity.read<Transform>().getX() == 5);
+
+	REQUIRE(transforms.has(entity));
+	REQUIRE_FALSE(world.accessor<Enemy>().has(entity));
+	REQUIRE_FALSE(transforms.has(stranger));
+
+	// Validated, since the tests are built with full checks
+	REQUIRE_THROWS(world.accessor<Enemy>()[entity]);
+	REQUIRE_THROWS(transforms[stranger]);
+	REQUIRE_THROWS(other.accessor<Transform>());
+}
+
+
+TEST_CASE("Checks follow the check level", "[world][check]")
+{
+	REQUIRE(DIVVY_CHECK_LEVEL == 2);
+
+	std::vector<int> values(3);
+	REQUIRE_NOTHROW(divvy::at(values, 2) = 5);
+	REQUIRE(values[2] == 5);
+	REQUIRE_THROWS_AS(divvy::at(values, 3), std::runtime_error);
+
+	World world;
+	world.add<Transform>();
+
+	Entity entity(world), invalid;
+
+	REQUIRE_THROWS_AS(entity.get<Transform>(), std::runtime_error);
+	REQUIRE_THROWS_AS(entity.mutate<Transform>(), std::runtime_error);
+	REQUIRE_THROWS_AS(invalid.get<Transform>(), std::runtime_error);
+	REQUIRE_THROWS_AS(invalid.add<Transform>(), std::runtime_error);
+}
+
+
+TEST_CASE("Logging goes through a sink", "[log]")
+{
+	RingLog ring(4);
+	SinkGuard guard(&ring);
+
+	World world;
+	world.add<Transform>();
+
+	Entity entity(world);
+	entity.add<Transform>();
+	entity.add<Transform>();
+
+	std::vector<LogRecord> records;
+	ring.drain([&](const LogRecord& record) { records.push_back(record); });
+
+	REQUIRE(ring.written() == 4);
+	REQUIRE(records.size() == 4);
+	REQUIRE(records[0].level == LogLevel::Info);
+	REQUIRE(records[1].entity == 0);
+	REQUIRE(records[3].level == LogLevel::Warning);
+
+	SECTION("the oldest records are overwritten")
+	{
+		for (int i = 0; i < 6; i++)
+			entity.add<Transform>();
+
+		records.clear();
+		ring.drain([&](const LogRecord& record) { records.push_back(record); });
+
+		REQUIRE(records.size() == 4);
+		REQUIRE(ring.written() == 10);
+	}
+
+	SECTION("records are formatted for streams")
+	{
+		std::ostringstream stream;
+		StreamSink sink(stream);
+		SinkGuard inner(&sink);
+
+		entity.reset();
+		REQUIRE(stream.str() == "-- DEBUG: Removed Entity (Entity #0)\n");
+	}
+}
+
+
+TEST_CASE("World keeps lifecycle statistics", "[world][stats]")
+{
+	World world;
+	world.add<Transform>();
+	world.add<Nametag>();
+	world.sampleStats(2);
+
+	Entity a(world), b(world), c(world);
+	a.add<Transform>();
+	b.add<Transform>();
+	b.add<Nametag>("b");
+
+	world.update();
+
+	REQUIRE(world.stats().created == 3);
+	REQUIRE(world.stats().resizes > 0);
+	REQUIRE(world.stats().resizes <= 6);
+	REQUIRE(world.stats().entities == 3);
+	REQUIRE(world.stats<Transform>().added == 2);
+	REQUIRE(world.stats<Nametag>().added == 1);
+
+	b.reset();
+	Entity d(world);
+	a.remove<Transform>();
+
+	world.update();
+
+	REQUIRE(world.stats().tick == 1);
+	REQUIRE(world.stats().created == 1);
+	REQUIRE(world.stats().destroyed == 1);
+	REQUIRE(world.stats().reuseRate() == Approx(1));
+	REQUIRE(world.stats().resizes == 0);
+	REQUIRE(world.stats<Transform>().removed == 2);
+	REQUIRE(world.stats<Nametag>().removed == 1);
+	REQUIRE(world.stats<Transform>().added == 0);
+
+	world.update();
+	world.update();
+
+	REQUIRE(world.stats<Transform>().removed == 0);
+
+	std::vector<size_t> ticks;
+	world.statsHistory([&](const TickStats& stats) { ticks.push_back(stats.tick); });
+
+	REQUIRE(ticks == std::vector<size_t>({2, 3}));
+
+	std::vector<Entity> many(100);
+	for (size_t i = 0; i < many.size(); i++)
+		many[i].reset(world);
+
+	world.update();
+
+	REQUIRE(world.stats().created == 100);
+	REQUIRE(world.stats().resizes > 0);
+	REQUIRE(world.stats().resizes < 40);
+}
+
+
+TEST_CASE("World reflects Component types", "[world][reflection]")
+{
+	World world;
+	world.add<Transform>();
+	world.add<Profile>();
+	world.add<Enemy>();
+
+	Entity a(world), b(world);
+	a.add<Transform>(3, 4);
+	a.add<Enemy>();
+	b.add<Transform>();
+	b.add<Profile>(5);
+
+	SECTION("registered types are enumerated")
+	{
+		size_t types = 0;
+		world.types([&](const ComponentType&) { types++; });
+		REQUIRE(types == 3);
+
+		ComponentType transform = world.type(typeid(Transform));
+		REQUIRE(transform.type() == typeid(Transform));
+		REQUIRE(transform.size() == sizeof(Transform));
+		REQUIRE(transform.alignment() == alignof(Transform));
+		REQUIRE(transform.count() == 2);
+		REQUIRE_FALSE(transform.trivial());
+
+		REQUIRE(world.type(typeid(Enemy)).tag());
+		REQUIRE(world.type(typeid(Profile)).shared());
+		REQUIRE(world.type(typeid(Profile)).trivial());
+		REQUIRE_THROWS(world.type(typeid(Nametag)));
+	}
+
+	SECTION("components of an Entity are inspected")
+	{
+		std::vector<std::string> names;
+		const void* transform = nullptr;
+
+		world.components(a, [&](const ComponentType& type, const void* bytes)
+		{
+			names.push_back(type.name());
+
+			if (type.type() == typeid(Transform))
+				transform = bytes;
+		});
+
+		REQUIRE(names.size() == 2);
+		REQUIRE(transform == &a.get<Transform>());
+		REQUIRE(world.type(typeid(Profile)).bytes(a) == nullptr);
+
+		Profile profile;
+		std::memcpy(&profile, world.type(typeid(Profile)).bytes(b), sizeof(Profile));
+		REQUIRE(profile.aggression == 5);
+	}
+}
+
+
+TEST_CASE("Entity slots are reused in constant time", "[world][entity]")
+{
+	World world;
+	world.add<Transform>();
+
+	std::vector<std::unique_ptr<Entity>> entities;
+
+	for (int i = 0; i < 100; i++)
+	{
+		entities.emplace_back(new Entity(world));
+		entities.back()->add<Transform>(i, i);
+	}
+
+	SECTION("removed slots are dead, the rest still resolve")
+	{
+		Entity& kept = *entities[10];
+		size_t generation = world.generation(kept);
+
+		for (size_t i = 0; i < entities.size(); i += 2)
+			entities[i]->reset();
+
+		REQUIRE_FALSE(entities[0]->valid());
+		REQUIRE(world.lookup(0, 0) == nullptr);
+		REQUIRE(world.lookup(11, 0) == entities[11].get());
+		REQUIRE(world.lookup(11, 0)->get<Transform>().getX() == 11);
+		REQUIRE(world.lookup(10, generation) == nullptr);
+	}
+
+	SECTION("a reused slot gets a new generation")
+	{
+		entities[42]->reset();
+
+		Entity reused(world);
+		REQUIRE_FALSE(reused.has<Transform>());
+		REQUIRE(world.lookup(42, 0) == nullptr);
+		REQUIRE(reused.id() == 42);
+		REQUIRE(world.lookup(42, world.generation(reused)) == &reused);
+		REQUIRE(world.generation(reused) == 1);
+		REQUIRE(world.generation(*entities[43]) == 0);
+	}
+
+	SECTION("Entities outliving their World are invalidated")
+	{
+		Entity survivor;
+		{
+			World temporary;
+			survivor.reset(temporary);
+			Entity removed(temporary);
+		}
+
+		REQUIRE_FALSE(survivor.valid());
+	}
+}
+
+
+TEST_CASE("Entities migrate between Worlds", "[world][migrate]")
+{
+	World source, target;
+	source.add<Transform>();
+	source.add<Nametag>();
+	source.add<Enemy>();
+	source.add<Profile>();
+	target.add<Transform>();
+	target.add<Nametag>();
+	target.add<Enemy>();
+	target.add<Profile>();
+
+	Entity keep(source);
+	Entity hero(source);
+	hero.add<Transform>(3, 4);
+	hero.add<Nametag>("a name too long for the small string buffer");
+	hero.add<Enemy>();
+	hero.add<Profile>(7);
+
+	SECTION("Components are moved and the slot is freed")
+	{
+		const char* buffer = hero.get<Nametag>().getName().data();
+		EntityID from = hero.id();
+
+		source.migrate(hero, target);
+
+		REQUIRE(hero.valid());
+		REQUIRE(target.lookup(hero.id(), target.generation(hero)) == &hero);
+		REQUIRE(source.lookup(from, 0) == nullptr);
+		REQUIRE(hero.read<Transform>().getX() == 3);
+		REQUIRE(hero.read<Nametag>().getName().data() == buffer);
+		REQUIRE(hero.has<Enemy>());
+		REQUIRE(hero.read<Profile>().aggression == 7);
+		REQUIRE(target.type(typeid(Transform)).count() == 1);
+		REQUIRE(source.type(typeid(Transform)).count() == 0);
+		REQUIRE(source.type(typeid(Nametag)).count() == 0);
+
+		Entity reused(source);
+		REQUIRE(reused.id() == from);
+		REQUIRE_FALSE(reused.has<Transform>());
+	}
+
+	SECTION("only types registered in both Worlds are kept")
+	{
+		target.remove<Nametag>();
+		hero.setEnabled(false);
+		source.migrate(hero, target);
+
+		REQUIRE(hero.has<Transform>());
+		REQUIRE_FALSE(hero.enabled());
+		REQUIRE(source.type(typeid(Nametag)).count() == 0);
+	}
+
+	SECTION("ranges of Entities are moved at once")
+	{
+		std::vector<Entity> crowd(10);
+
+		for (size_t i = 0; i < crowd.size(); i++)
+		{
+			crowd[i].reset(source);
+			crowd[i].add<Transform>(static_cast<int>(i), 0);
+		}
+
+		source.migrate(crowd.begin(), crowd.end(), target);
+
+		for (size_t i = 0; i < crowd.size(); i++)
+			REQUIRE(crowd[i].read<Transform>().getX() == static_cast<int>(i));
+
+		REQUIRE(target.type(typeid(Transform)).count() == 10);
+		REQUIRE_THROWS(source.migrate(crowd.begin(), crowd.end(), target));
+	}
+}
+
+
+TEST_CASE("Sharded Worlds tick in parallel", "[sharded]")
+{
+	ShardedWorld<int> world(4, [](const int& region) { return static_cast<size_t>(region / 100); });
+	world.add<Transform>();
+
+	std::vector<Entity> entities(40);
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		int x = static_cast<int>(i) * 10;
+		entities[i].reset(world[x]);
+		entities[i].add<Transform>(x, 0);
+	}
+
+	SECTION("Entities are partitioned by key")
+	{
+		REQUIRE(world.size() == 4);
+		REQUIRE(world.locate(entities[0]) == 0);
+		REQUIRE(world.locate(entities[15]) == 1);
+		REQUIRE(world.locate(Entity()) == ShardedWorld<int>::npos());
+		REQUIRE(world.shard(3).type(typeid(Transform)).count() == 10);
+		REQUIRE_THROWS(world.shardOf(400));
+	}
+
+	SECTION("every shard updates, crossings migrate at the sync point")
+	{
+		world.system([&](World& shard)
+		{
+			for (size_t i = 0; i < entities.size(); i++)
+				if (entities[i].world() == &shard && entities[i].get<Transform>().getX() >= 390)
+					world.migrate(entities[i], 0);
+		});
+
+		ShardHandle handle = world.handle(entities[39]);
+		REQUIRE(world.resolve(handle) == &entities[39]);
+
+		world.update();
+
+		REQUIRE(entities[0].read<Transform>().getX() == 1);
+		REQUIRE(entities[39].read<Transform>().getX() == 391);
+		REQUIRE(world.locate(entities[39]) == 0);
+		REQUIRE(world.locate(entities[38]) == 3);
+		REQUIRE(world.resolve(handle) == nullptr);
+		REQUIRE(world.resolve(world.handle(entities[39])) == &entities[39]);
+	}
+
+	SECTION("queued Entities removed or moved before the sync point are handled")
+	{
+		world.migrate(entities[10], 0);
+		world.migrate(entities[20], 0);
+		Entity loose;
+		world.migrate(loose, 0);
+
+		entities[10].reset();
+		Entity moved(std::move(entities[20]));
+
+		world.sync();
+
+		REQUIRE(world.locate(entities[10]) == ShardedWorld<int>::npos());
+		REQUIRE(world.locate(moved) == 0);
+		REQUIRE(moved.read<Transform>().getX() == 200);
+	}
+
+	SECTION("the worker threads are reused by every update")
+	{
+		for (int i = 0; i < 5; i++)
+			world.update();
+
+		REQUIRE(entities[0].read<Transform>().getX() == 5);
+		REQUIRE(entities[39].read<Transform>().getX() == 395);
+	}
+
+	SECTION("exceptions thrown by a shard reach the caller")
+	{
+		REQUIRE_THROWS(world.parallel([](World& shard)
+		{
+			if (shard.type(typeid(Transform)).count() == 10)
+				throw std::runtime_error("shard failed");
+		}));
+	}
+}
+
+
+TEST_CASE("World state hashes deterministically", "[world][hash]")
+{
+	struct Label : public Component
+	{
+		virtual void update() {}
+		virtual void clone(const Component& other) { text = cast<Label>(other).text; }
+		uint64_t hash() const { return hash::bytes(text.data(), text.size()); }
+
+		std::string text;
+	};
+
+	World a, b;
+	std::vector<Entity> as(20), bs(20);
+
+	for (World* world : {&a, &b})
+	{
+		world->add<Transform>();
+		world->add<Label>();
+		world->add<Enemy>();
+		world->add<Profile>();
+	}
+
+	for (size_t i = 0; i < as.size(); i++)
+	{
+		int x = static_cast<int>(i);
+		as[i].reset(a);
+		bs[i].reset(b);
+		as[i].add<Transform>(x, -x);
+		bs[i].add<Transform>(x, -x);
+		as[i].add<Profile>(x % 3);
+		bs[i].add<Profile>(x % 3);
+	}
+
+	as[4].add<Label>().text = "a label on the heap, not inline in the Component";
+	bs[4].add<Label>().text = std::string("a label on the heap, not inline in the Component");
+	as[7].add<Enemy>();
+	bs[7].add<Enemy>();
+
+	SECTION("equal states hash equally")
+	{
+		REQUIRE(a.hash() == b.hash());
+
+		a.update();
+		b.update();
+		REQUIRE(a.hash() == b.hash());
+	}
+
+	SECTION("diverging states are localized to their type")
+	{
+		uint64_t before = a.hash();
+		as[3].get<Transform>().setX(100);
+
+		REQUIRE(a.hash() != before);
+		REQUIRE(a.hash() != b.hash());
+
+		std::vector<std::string> diverged;
+		std::map<std::string, uint64_t> hashes;
+		b.hashes([&](const ComponentType& type, uint64_t hash) { hashes[type.name()] = hash; });
+		a.hashes([&](const ComponentType& type, uint64_t hash)
+		{
+			if (hashes[type.name()] != hash)
+				diverged.push_back(type.name());
+		});
+
+		REQUIRE(diverged.size() == 1);
+		REQUIRE(diverged[0] == typeid(Transform).name());
+
+		bs[3].get<Transform>().setX(100);
+		REQUIRE(a.hash() == b.hash());
+	}
+
+	SECTION("types hashed by neither method are refused")
+	{
+		struct Opaque : public Component
+		{
+			virtual void update() {}
+			virtual void clone(const Component&) {}
+
+			std::string text;
+		};
+
+		a.add<Opaque>();
+		as[0].add<Opaque>();
+
+		REQUIRE_THROWS(a.hash());
+	}
+
+	SECTION("tracked changes are hashed incrementally")
+	{
+		a.hash();
+		as[5].reset();
+		as[6].remove<Profile>();
+		as[7].remove<Enemy>();
+		as[4].mutate<Label>().text = "renamed";
+
+		bs[5].reset();
+		bs[6].remove<Profile>();
+		bs[7].remove<Enemy>();
+		bs[4].mutate<Label>().text = "renamed";
+
+		REQUIRE(a.hash() == b.hash());
+
+		as[7].add<Enemy>();
+		REQUIRE(a.hash() != b.hash());
+	}
+}
+
+
+TEST_CASE("World hashes only the Components written since", "[world][hash]")
+{
+	struct Score : public Component
+	{
+		Score() {}
+
+		Score(int points) : points(points) {}
+
+		virtual void clone(const Component& other) { points = cast<Score>(other).points; }
+
+		uint64_t hash() const
+		{
+			hashed()++;
+			return static_cast<uint64_t>(points);
+		}
+
+		static size_t& hashed()
+		{
+			static size_t count = 0;
+			return count;
+		}
+
+		int points = 0;
+	};
+
+	World world;
+	world.add<Score>();
+
+	std::vector<Entity> entities(100);
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		entities[i].reset(world);
+		entities[i].add<Score>(static_cast<int>(i));
+	}
+
+	world.system([&](World&) { entities[3].get<Score>().points++; });
+	uint64_t before = world.hash();
+	Score::hashed() = 0;
+
+	REQUIRE(entities[3].read<Score>().points == 3);
+	REQUIRE(world.hash() == before);
+	REQUIRE(Score::hashed() == 0);
+
+	world.update();     // Only the system writes a score
+	REQUIRE(world.hash() != before);
+	REQUIRE(Score::hashed() == 1);
+}
+
+
+TEST_CASE("World rolls back to saved frames", "[world][rollback]")
+{
+	World world;
+	world.add<Transform>();
+	world.add<Nametag>();
+	world.add<Enemy>();
+	world.add<Profile>();
+
+	std::vector<Entity> entities(1000);
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		entities[i].reset(world);
+		entities[i].add<Transform>(static_cast<int>(i), 0);
+	}
+
+	entities[0].add<Nametag>("first");
+	entities[1].add<Profile>(1);
+
+	REQUIRE_THROWS(world.save());
+	world.setRollback(4);
+
+	auto transforms = [&]()
+	{
+		uint64_t result = 0;
+		world.hashes([&](const ComponentType& type, uint64_t hash)
+		{
+			if (type.type() == typeid(Transform))
+				result = hash;
+		});
+		return result;
+	};
+
+	SECTION("earlier frames are restored")
+	{
+		size_t first = world.save();
+		uint64_t hash = transforms();
+
+		world.update();
+		size_t second = world.save();
+
+		entities[0].mutate<Nametag>().setName("renamed");
+		entities[1].mutate<Profile>().aggression = 5;
+		entities[2].add<Enemy>();
+		entities[3].remove<Transform>();
+
+		world.restore(second);
+		REQUIRE(entities[0].read<Nametag>().getName() == "first");
+		REQUIRE(entities[1].read<Profile>().aggression == 1);
+		REQUIRE_FALSE(entities[2].has<Enemy>());
+		REQUIRE(entities[3].read<Transform>().getX() == 4);
+
+		world.restore(first);
+		REQUIRE(entities[3].read<Transform>().getX() == 3);
+		REQUIRE(transforms() == hash);
+		REQUIRE_THROWS(world.restore(second));
+	}
+
+	SECTION("pages left unchanged by an update are not copied")
+	{
+		for (size_t i = PageHistory<Transform>::slots(); i < entities.size(); i++)
+			entities[i].setEnabled<Transform>(false);
+
+		world.save();
+		world.update();
+		world.save();
+		world.update();
+
+		REQUIRE(world.stats<Transform>().saved == 1);
+		REQUIRE(world.stats<Enemy>().saved == 0);
+		REQUIRE(entities[0].read<Transform>().getX() == 2);
+		REQUIRE(entities[entities.size() - 1].read<Transform>().getX() == static_cast<int>(entities.size() - 1));
+	}
+
+	SECTION("only frames in the ring are kept")
+	{
+		size_t first = world.save();
+
+		for (int i = 0; i < 4; i++)
+		{
+			entities[5].mutate<Transform>().setX(100 + i);
+			world.save();
+		}
+
+		REQUIRE_THROWS(world.restore(first));
+
+		world.restore(first + 1);
+		REQUIRE(entities[5].read<Transform>().getX() == 100);
+	}
+
+	SECTION("Entities removed since lose their restored Components")
+	{
+		size_t frame = world.save();
+		Entity moved(std::move(entities[7]));
+		entities[8].reset();
+
+		world.restore(frame);
+		REQUIRE(moved.read<Transform>().getX() == 7);
+		REQUIRE(world.type(typeid(Transform)).count() == entities.size() - 1);
+
+		Entity reused(world);
+		REQUIRE_FALSE(reused.has<Transform>());
+	}
 }
 
 
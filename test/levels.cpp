@@ -0,0 +1,89 @@
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "divvy.hpp"
+
+using namespace divvy;
+
+/*
+* Built once per lower check level, with DIVVY_CHECK_LEVEL defined by CMake, so that the
+* assertion-only and unchecked hot paths are compiled and run on valid use.
+*/
+
+
+//================================[ Fixtures ]===========================================
+
+
+struct Counter : public Component
+{
+	Counter() {}
+
+	Counter(int value) : value(value) {}
+
+	virtual void update() { value++; }
+	virtual void clone(const Component& other) { value = cast<Counter>(other).value; }
+
+	int value = 0;
+};
+
+struct Marked {};
+
+struct Team : public SharedComponent
+{
+	Team() {}
+
+	Team(int id) : id(id) {}
+
+	bool operator==(const Team& other) const { return id == other.id; }
+
+	uint64_t hash() const { return static_cast<uint64_t>(id); }
+
+	int id = 0;
+};
+
+
+//================================[ Test Cases ]=========================================
+
+
+TEST_CASE("Hot paths work at the lower check levels", "[check]")
+{
+	REQUIRE(DIVVY_CHECK_LEVEL < 2);
+
+	std::vector<int> values(3);
+	divvy::at(values, 2) = 5;
+	REQUIRE(values[2] == 5);
+
+	World world;
+	world.add<Counter>();
+	world.add<Marked>();
+	world.add<Team>();
+
+	Entity a(world), b(world);
+
+	a.add<Counter>(1);
+	b.add<Counter>(2);
+	a.add<Marked>();
+	a.add<Team>(3);
+	b.add<Team>(3);
+
+	REQUIRE(a.read<Counter>().value == 1);
+	REQUIRE(a.has<Marked>());
+	REQUIRE_FALSE(b.has<Marked>());
+	REQUIRE(&a.get<Team>() == &b.get<Team>());
+
+	a.mutate<Counter>().value = 10;
+	world.update();
+
+	Accessor<Counter> counters = world.accessor<Counter>();
+	REQUIRE(counters[a].value == 11);
+	REQUIRE(counters[b].value == 3);
+
+	b.mutate<Team>().id = 4;
+	REQUIRE(a.read<Team>().id == 3);
+	REQUIRE(b.read<Team>().id == 4);
+
+	a.remove<Counter>();
+	REQUIRE_FALSE(a.has<Counter>());
+}